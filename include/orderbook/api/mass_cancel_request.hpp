@@ -0,0 +1,46 @@
+#ifndef MASS_CANCEL_REQUEST_HPP
+#define MASS_CANCEL_REQUEST_HPP
+
+#include <utility>
+
+#include "orderbook/types.hpp"
+
+namespace orderbook::api {
+
+// Filters combine; an empty request cancels every order in every book.
+// The price range selects resting orders by level price and pending stops
+// by stop price.
+struct MassCancelRequest {
+    bool     hasSymbol{false};
+    bool     hasSide{false};
+    bool     hasPriceRange{false};
+    bool     hasOwner{false};
+
+    Symbol   symbol{};
+    Side     side{Side::Buy};
+    Price    minPrice{0.0};
+    Price    maxPrice{0.0};
+    OwnerId  owner{INVALID_OWNER_ID};
+
+    MassCancelRequest() = default;
+
+    static MassCancelRequest for_symbol(Symbol symbol)
+    {
+        MassCancelRequest req;
+        req.hasSymbol = true;
+        req.symbol    = std::move(symbol);
+        return req;
+    }
+
+    static MassCancelRequest for_owner(OwnerId owner)
+    {
+        MassCancelRequest req;
+        req.hasOwner = true;
+        req.owner    = owner;
+        return req;
+    }
+};
+
+}
+
+#endif
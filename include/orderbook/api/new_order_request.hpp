@@ -5,6 +5,7 @@
 #include <string>
 
 #include "orderbook/types.hpp"
+#include "orderbook/util/timestamp.hpp"
 
 namespace orderbook::api {
 
@@ -17,6 +18,30 @@ struct NewOrderRequest {
     Price       price;
     Quantity    quantity;
 
+    OwnerId     owner{INVALID_OWNER_ID};
+    SelfTradePrevention stp{SelfTradePrevention::None};
+
+    // stop orders: StopMarket requires type Market, StopLimit requires type Limit
+    bool        isStop{false};
+    StopType    stopType{StopType::StopMarket};
+    Price       stopPrice{0.0};
+
+    // iceberg peak size, 0 means the whole quantity is displayed
+    Quantity    displayQuantity{0};
+
+    // pegged limit orders: price is ignored, the order tracks the peg
+    // reference plus pegOffset (negative = lower price)
+    PegType     pegType{PegType::None};
+    Price       pegOffset{0.0};
+
+    // non-displayed limit order crossing at the lit midpoint in executions
+    // of at least minQuantity; the symbol must have its dark book enabled
+    bool        isDark{false};
+    Quantity    minQuantity{0};
+
+    // GTD only; DAY orders expire at the engine's session end
+    orderbook::util::Timestamp expireTime{orderbook::util::Timestamp::time_point{}};
+
     NewOrderRequest() = default;
 
     NewOrderRequest(Symbol      symbol,
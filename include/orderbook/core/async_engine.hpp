@@ -0,0 +1,185 @@
+#ifndef ASYNC_ENGINE_HPP
+#define ASYNC_ENGINE_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "orderbook/types.hpp"
+#include "orderbook/api/new_order_request.hpp"
+#include "orderbook/api/modify_order_request.hpp"
+#include "orderbook/core/trade.hpp"
+#include "orderbook/core/matching_engine.hpp"
+#include "orderbook/util/wait_strategy.hpp"
+
+namespace orderbook::core {
+
+using orderbook::util::WaitStrategy;
+
+// an order as the async front end addresses it: cancels and modifies are
+// routed by symbol, so they stay in order with that symbol's new orders
+struct OrderRef {
+    OrderId orderId{INVALID_ORDER_ID};
+    Symbol  symbol;
+};
+
+// outcome of an asynchronous new order: the order (id INVALID_ORDER_ID and
+// a reason if rejected) and every trade the request produced, stop
+// cascades included
+struct SubmitResult {
+    OrderRef                order;
+    orderbook::RejectReason reason{orderbook::RejectReason::None};
+    std::vector<Trade>      trades;
+};
+
+// outcome of an asynchronous modify; trades are those of a rematch
+struct ModifyResult {
+    bool               accepted{false};
+    std::vector<Trade> trades;
+};
+
+// Coroutine front end of a MatchingEngine. Requests are queued to worker
+// shards and executed there, so the thread that issues them never blocks
+// on a symbol lock:
+//
+//     SubmitResult r = co_await async.submit(req);
+//
+// Every request goes to the shard of its symbol, so one symbol's new
+// orders, cancels and modifies run in issue order. A finished request is put on one completion queue and its
+// coroutine resumes inside poll() / wait(), on the thread calling them
+// (the gateway's event loop), never on a worker. Awaitables must be
+// co_awaited at once and the coroutine frame kept alive until resumed;
+// coroutines still waiting when the AsyncEngine is destroyed are not resumed.
+class AsyncEngine {
+public:
+    struct Options {
+        std::size_t      shards{1};
+        WaitStrategy     wait{WaitStrategy::Blocking};   // how an idle worker waits for commands
+        std::vector<int> cpus;                           // worker i runs on cpus[i % size], empty = unpinned
+    };
+
+    AsyncEngine(MatchingEngine& engine, const Options& options);
+    explicit AsyncEngine(MatchingEngine& engine) : AsyncEngine(engine, Options{}) {}
+    ~AsyncEngine();
+
+    AsyncEngine(const AsyncEngine&) = delete;
+    AsyncEngine& operator=(const AsyncEngine&) = delete;
+
+    // a queued request, completed by a worker; the awaitables below
+    class Command {
+    public:
+        virtual ~Command() = default;
+
+    protected:
+        friend class AsyncEngine;
+
+        virtual void execute(MatchingEngine& engine) = 0;
+
+        std::coroutine_handle<> handle_;
+    };
+
+    template <typename Result>
+    class Awaitable : public Command {
+    public:
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h)
+        {
+            handle_ = h;
+            async_.enqueue(shard_, this);
+        }
+        Result await_resume() { return std::move(result_); }
+
+    protected:
+        Awaitable(AsyncEngine& async, std::size_t shard) : async_(async), shard_(shard) {}
+
+        AsyncEngine& async_;
+        std::size_t  shard_;
+        Result       result_{};
+    };
+
+    class SubmitAwaitable : public Awaitable<SubmitResult> {
+    public:
+        SubmitAwaitable(AsyncEngine& async, const NewOrderRequest& req)
+            : Awaitable(async, async.shard_of(req.symbol)), req_(req) {}
+
+    private:
+        void execute(MatchingEngine& engine) override;
+        NewOrderRequest req_;
+    };
+
+    class CancelAwaitable : public Awaitable<bool> {
+    public:
+        CancelAwaitable(AsyncEngine& async, const OrderRef& order)
+            : Awaitable(async, async.shard_of(order.symbol)), orderId_(order.orderId) {}
+
+    private:
+        void execute(MatchingEngine& engine) override;
+        OrderId orderId_;
+    };
+
+    class ModifyAwaitable : public Awaitable<ModifyResult> {
+    public:
+        ModifyAwaitable(AsyncEngine& async, const OrderRef& order, const ModifyOrderRequest& req)
+            : Awaitable(async, async.shard_of(order.symbol)), orderId_(order.orderId), req_(req) {}
+
+    private:
+        void execute(MatchingEngine& engine) override;
+        OrderId            orderId_;
+        ModifyOrderRequest req_;
+    };
+
+    SubmitAwaitable submit(const NewOrderRequest& req) { return SubmitAwaitable(*this, req); }
+    CancelAwaitable cancel(const OrderRef& order) { return CancelAwaitable(*this, order); }
+    ModifyAwaitable modify(const OrderRef& order, const ModifyOrderRequest& req) { return ModifyAwaitable(*this, order, req); }
+
+    // resume every coroutine whose request has completed; returns how many.
+    // Call from one thread at a time
+    std::size_t poll();
+
+    // as poll(), first blocking until at least one request has completed;
+    // returns 0 at once when nothing is in flight
+    std::size_t wait();
+
+    // requests issued and not yet resumed
+    std::size_t in_flight() const noexcept { return inFlight_.load(std::memory_order_relaxed); }
+
+private:
+    // commands for one worker; producers append under the lock, the worker
+    // takes the whole batch at once
+    struct Shard {
+        std::mutex              mutex;
+        std::condition_variable ready;
+        std::vector<Command*>   commands;
+        std::atomic<bool>       pending{false};
+        std::thread             worker;
+    };
+
+    MatchingEngine&                     engine_;
+    const WaitStrategy                  wait_;
+    const std::uint64_t                 listener_;   // tags the trades this front end collects
+    MatchingEngine::TradeListenerId     tradeListenerId_{0};
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<bool>                   stop_{false};
+    std::atomic<std::size_t>            inFlight_{0};
+
+    std::mutex                           completedMutex_;
+    std::condition_variable              completedReady_;
+    std::vector<std::coroutine_handle<>> completed_;
+    std::vector<std::coroutine_handle<>> resuming_;   // poll()'s batch, reused
+
+    std::size_t shard_of(const Symbol& symbol) const noexcept;
+
+    void enqueue(std::size_t shard, Command* command);
+    void run_worker(Shard& shard, int cpu);
+    void complete(const std::vector<Command*>& batch);
+};
+
+}
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef AUCTION_HPP
+#define AUCTION_HPP
+
+#include <vector>
+
+#include "orderbook/types.hpp"
+
+namespace orderbook::core {
+
+// Executable quantity (displayed and iceberg reserve) of one level.
+struct AuctionLevel {
+    Price    price{0.0};
+    Quantity quantity{0};
+};
+
+// Quantity one order contributes to an uncross, in its side's priority order.
+struct AuctionAllocation {
+    OrderId  orderId{INVALID_ORDER_ID};
+    Quantity quantity{0};
+};
+
+struct AuctionResult {
+    Price    price{0.0};     // uncrossing price, 0.0 when the book does not cross
+    Quantity volume{0};      // executable at price
+    Quantity surplus{0};     // buy minus sell quantity at price, unmatched remainder
+};
+
+// Uncrossing price of a call auction from both sides' levels, each in
+// ascending price order, in one merge pass. Among level prices it picks,
+// in turn:
+//  1. the maximum executable volume,
+//  2. the minimum absolute surplus,
+//  3. market pressure: the highest tied price if every tie has a buy
+//     surplus, the lowest if every tie has a sell surplus,
+//  4. the tied price closest to reference (lower on equal distance).
+AuctionResult compute_uncross(const std::vector<AuctionLevel>& bids,
+                              const std::vector<AuctionLevel>& asks,
+                              Price reference);
+
+}
+
+#endif
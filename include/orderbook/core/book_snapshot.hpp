@@ -0,0 +1,41 @@
+#ifndef BOOK_SNAPSHOT_HPP
+#define BOOK_SNAPSHOT_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "orderbook/types.hpp"
+#include "orderbook/core/depth_level.hpp"
+
+namespace orderbook::core {
+
+// Top-of-book view published by OrderBook after every mutation. Plain data
+// so it can be copied out of the book's seqlock without touching the book.
+struct BookSnapshot {
+    static constexpr std::size_t kDepth = 10;
+
+    std::array<DepthLevel, kDepth> bids{};  // best first
+    std::array<DepthLevel, kDepth> asks{};  // best first
+    std::uint32_t bidDepth{0};              // valid entries in bids
+    std::uint32_t askDepth{0};              // valid entries in asks
+
+    std::uint64_t bidOrders{0};             // resting orders on the whole side
+    std::uint64_t askOrders{0};
+
+    Price         lastTradePrice{0.0};      // 0.0 until the first trade
+    TradingState  state{TradingState::Continuous};
+    std::uint64_t version{0};               // bumped on every publish
+};
+
+// Best prices and last trade only, published with every BookSnapshot for
+// readers that need a reference price without copying the depth.
+struct BookTouch {
+    Price bestBid{0.0};          // 0.0 when the side is empty
+    Price bestAsk{0.0};
+    Price lastTradePrice{0.0};
+};
+
+}
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef DARK_BOOK_HPP
+#define DARK_BOOK_HPP
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory_resource>
+#include <vector>
+
+#include "orderbook/types.hpp"
+#include "orderbook/core/order.hpp"
+#include "orderbook/core/fill.hpp"
+
+namespace orderbook::core {
+
+// when incoming lit orders reach the dark book
+enum class DarkPriority {
+    BeforeLit,   // cross at the midpoint first, then sweep the lit book
+    AfterLit     // sweep the lit book first, the remainder crosses at the new midpoint
+};
+
+// Non-displayed midpoint orders of one symbol. Every trade prints at the lit
+// book's midpoint; an order takes part while its limit is at or through the
+// mid and the execution is at least its minimum quantity (or what is left of
+// it). Sides are indexed by limit price, most aggressive first, and kept in
+// time order within a price.
+class DarkBook {
+public:
+    explicit DarkBook(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : buys_(resource), sells_(resource) {}
+
+    void add_order(Order* order);
+
+    bool remove_order(const Order& order);
+
+    std::size_t remove_orders_if(const OrderPredicate& pred, std::vector<Order*>& removed);
+
+    // trade incoming against the other side at mid; resting orders it fills
+    // go to completed, those cancelled by self-trade prevention to cancelled
+    void match(Order& incoming, Price mid, FillBuffer& fills,
+               std::vector<Order*>& completed, std::vector<Order*>& cancelled);
+
+    bool empty() const noexcept { return buyCount_ + sellCount_ == 0; }
+    bool empty(Side side) const noexcept { return (side == Side::Buy ? buyCount_ : sellCount_) == 0; }
+    std::size_t order_count() const noexcept { return buyCount_ + sellCount_; }
+
+private:
+    using DarkQueue = std::pmr::deque<Order*>;
+
+    std::pmr::map<Price, DarkQueue, std::greater<Price>> buys_;    // highest limit first
+    std::pmr::map<Price, DarkQueue>                      sells_;   // lowest limit first
+    std::size_t buyCount_{0};
+    std::size_t sellCount_{0};
+};
+
+}
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef DEPTH_INDEX_HPP
+#define DEPTH_INDEX_HPP
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "orderbook/types.hpp"
+
+namespace orderbook::core {
+
+// Fenwick tree of resting quantity over fixed-width price buckets, giving
+// O(log n) cumulative depth. Prices are not tick-aligned in this engine, so
+// a bucket may hold several levels; callers resolve the boundary bucket
+// against the exact levels. The covered range and the bucket width adapt
+// on reset(): the width doubles whenever the range would need more than
+// kMaxBuckets, which bounds memory per side.
+class DepthIndex {
+public:
+    using Bucket = std::int64_t;
+
+    static constexpr Price       kInitialWidth = 0.01;
+    static constexpr std::size_t kMinBuckets   = 64;
+    static constexpr std::size_t kMaxBuckets   = std::size_t{1} << 14;
+
+    explicit DepthIndex(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : tree_(resource) {}
+
+    bool covers(Price price) const;
+
+    // cover [minPrice, maxPrice] with slack on both sides; clears all sums
+    void reset(Price minPrice, Price maxPrice);
+
+    void add(Price price, Quantity delta);
+
+    Bucket bucket_of(Price price) const;
+
+    // lowest price of bucket b
+    Price bucket_floor(Bucket b) const { return static_cast<Price>(b) * width_; }
+
+    // quantity in buckets strictly before b
+    Quantity sum_before(Bucket b) const;
+
+    // first bucket whose inclusive prefix exceeds threshold; before receives
+    // the prefix up to it. Requires threshold < total().
+    Bucket first_exceeding(Quantity threshold, Quantity& before) const;
+
+    Quantity total() const noexcept { return total_; }
+
+private:
+    Price    width_{kInitialWidth};
+    Bucket   base_{0};          // bucket stored at tree index 1
+    Quantity total_{0};
+    std::pmr::vector<Quantity> tree_;  // 1-based, tree_[0] unused
+};
+
+}
+
+#endif
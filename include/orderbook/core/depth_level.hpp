@@ -0,0 +1,42 @@
+#ifndef DEPTH_LEVEL_HPP
+#define DEPTH_LEVEL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "orderbook/types.hpp"
+
+namespace orderbook::core {
+
+// One market-by-price level. Fixed-width plain data, so arrays of it can
+// be copied into seqlock snapshots or market-data messages as is.
+struct DepthLevel {
+    Price         price{0.0};
+    Quantity      quantity{0};    // displayed quantity
+    std::uint32_t orderCount{0};
+};
+
+static_assert(std::is_trivially_copyable_v<DepthLevel> && std::is_standard_layout_v<DepthLevel>,
+              "DepthLevel must stay plain data");
+
+struct DepthSummary {
+    std::size_t bidLevels{0};
+    std::size_t askLevels{0};
+    Quantity    bidQuantity{0};   // over the returned levels
+    Quantity    askQuantity{0};
+    double      imbalance{0.0};   // (bid - ask) / (bid + ask), in [-1, 1]
+};
+
+// turn levels into running totals: entry i covers levels 0..i, prices unchanged
+void accumulate_depth(DepthLevel* levels, std::size_t count);
+
+// total displayed quantity of count levels
+Quantity depth_quantity(const DepthLevel* levels, std::size_t count);
+
+// 0 when both sides are empty
+double depth_imbalance(Quantity bidQuantity, Quantity askQuantity);
+
+}
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef ENGINE_CONFIG_HPP
+#define ENGINE_CONFIG_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory_resource>
+#include <vector>
+
+#include "orderbook/types.hpp"
+#include "orderbook/util/wait_strategy.hpp"
+#include "orderbook/util/huge_page_arena.hpp"
+
+namespace orderbook::core {
+
+using orderbook::util::WaitStrategy;
+using orderbook::util::HugePageSize;
+
+// Placement and threading knobs of a MatchingEngine. The engine runs on its
+// callers' threads, so pinning those is the caller's job (see
+// util::pin_current_thread); the engine places its own memory and decides
+// how those threads wait for its locks.
+struct EngineConfig {
+    // resource a symbol's book pools its containers on; nullptr (or no
+    // function) falls back to the engine's resource below
+    using BookMemory = std::function<std::pmr::memory_resource*(const Symbol&)>;
+
+    // books created at construction, see MatchingEngine::register_symbols
+    std::vector<Symbol> symbols;
+
+    // order slots allocated and written at construction
+    std::size_t orderPoolCapacity{0};
+
+    // CPU the constructor runs on while it allocates the books and order
+    // pool, so first touch puts them on that CPU's NUMA node; -1 = as is
+    int homeCpu{-1};
+
+    // bytes of huge-page backed memory for the order pool and the price
+    // levels of every book, mapped and pre-faulted at construction (on the
+    // home CPU); falls back to normal pages if huge pages are unavailable
+    // and to the heap once used up. 0 = heap only
+    std::size_t  hugePageArenaBytes{0};
+    HugePageSize hugePageSize{HugePageSize::Size2MB};
+
+    // upstream of the order pool, the order registry and the books in place
+    // of the arena (a monotonic buffer, a synchronized pool, ...); it must
+    // outlive the engine and be safe to call from every request thread
+    std::pmr::memory_resource* memory{nullptr};
+
+    // per-book override of memory, called once when the book is created
+    BookMemory bookMemory;
+
+    // how a request waits for a symbol lock or the order registry held by
+    // another thread; spinning only pays on isolated, pinned cores
+    WaitStrategy lockWait{WaitStrategy::Blocking};
+};
+
+}
+
+#endif
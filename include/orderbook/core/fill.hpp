@@ -0,0 +1,57 @@
+#ifndef FILL_HPP
+#define FILL_HPP
+
+#include <cstddef>
+#include <memory_resource>
+#include <type_traits>
+#include <vector>
+
+#include "orderbook/types.hpp"
+
+namespace orderbook::core {
+
+// One execution as produced by matching. Symbol, trade id and timestamp are
+// added when the engine turns fills into Trades for publishing.
+struct Fill {
+    OrderId  buyOrderId{INVALID_ORDER_ID};
+    OrderId  sellOrderId{INVALID_ORDER_ID};
+    Price    price{0.0};
+    Quantity quantity{0};
+};
+
+static_assert(std::is_trivially_copyable_v<Fill>, "Fill must stay a plain record");
+
+// Caller-owned output buffer for matching. Capacity is reserved up front and
+// kept across clear(), so a sweep that fits allocates nothing; a larger one
+// grows the buffer once instead of being truncated.
+class FillBuffer {
+public:
+    static constexpr std::size_t kDefaultCapacity = 1024;
+
+    explicit FillBuffer(std::size_t capacity = kDefaultCapacity,
+                        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : fills_(resource)
+    {
+        fills_.reserve(capacity);
+    }
+
+    void push(const Fill& fill) { fills_.push_back(fill); }
+    void clear() noexcept { fills_.clear(); }
+
+    std::size_t size() const noexcept { return fills_.size(); }
+    std::size_t capacity() const noexcept { return fills_.capacity(); }
+    bool empty() const noexcept { return fills_.empty(); }
+
+    const Fill& operator[](std::size_t i) const { return fills_[i]; }
+    const Fill& back() const { return fills_.back(); }
+
+    const Fill* begin() const noexcept { return fills_.data(); }
+    const Fill* end() const noexcept { return fills_.data() + fills_.size(); }
+
+private:
+    std::pmr::vector<Fill> fills_;
+};
+
+}
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef MATCH_POLICY_HPP
+#define MATCH_POLICY_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "orderbook/types.hpp"
+#include "orderbook/core/price_level.hpp"
+
+namespace orderbook::core {
+
+// Per-level allocation scratch, reused across matches.
+struct AllocationScratch {
+    std::vector<Quantity>     alloc;    // share of each queue entry, queue order
+    std::vector<std::size_t>  rank;     // entry indices in allocation order
+    std::vector<RestingOrder> requeue;  // iceberg peaks refreshed after an allocation
+};
+
+// Allocation policies for OrderBookSide::match. A policy that allocates
+// splits an incoming quantity smaller than a level's displayed volume
+// across the level's orders in one pass (allocate), then the side applies
+// the shares in a second pass. Quantities that take a whole level, and
+// FIFO books, go through the plain time-priority loop.
+//
+// kTopOrderPriority: the front order of each level is first filled in
+// time priority before the rest of the level is allocated.
+
+struct FifoMatch {
+    static constexpr bool kAllocates        = false;
+    static constexpr bool kTopOrderPriority = false;
+};
+
+// Shares proportional to displayed size, rounded down; the lots lost to
+// rounding go to the oldest orders with room left.
+struct ProRataMatch {
+    static constexpr bool kAllocates        = true;
+    static constexpr bool kTopOrderPriority = false;
+
+    static void allocate(const PriceLevel::OrdersQueue& queue, Quantity qty, Quantity levelVolume,
+                         AllocationScratch& scratch);
+};
+
+struct ProRataTopOrderMatch : ProRataMatch {
+    static constexpr bool kTopOrderPriority = true;
+};
+
+// Largest displayed order first, time breaking ties.
+struct SizeTimeMatch {
+    static constexpr bool kAllocates        = true;
+    static constexpr bool kTopOrderPriority = false;
+
+    static void allocate(const PriceLevel::OrdersQueue& queue, Quantity qty, Quantity levelVolume,
+                         AllocationScratch& scratch);
+};
+
+}
+
+#endif
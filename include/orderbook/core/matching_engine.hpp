@@ -4,65 +4,173 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <memory>
+#include <utility>
 #include <vector>
 #include <functional>
 #include <mutex>
 #include <shared_mutex>
+#include <atomic>
 
 #include "orderbook/api/new_order_request.hpp"
+#include "orderbook/api/mass_cancel_request.hpp"
 #include "orderbook/core/order.hpp"
 #include "orderbook/core/trade.hpp"
+#include "orderbook/core/fill.hpp"
 #include "orderbook/core/order_book.hpp"
+#include "orderbook/core/symbol_directory.hpp"
+#include "orderbook/core/engine_config.hpp"
 #include "orderbook/util/i_clock.hpp"
 #include "orderbook/util/id_generator.hpp"
+#include "orderbook/util/timer_wheel.hpp"
+#include "orderbook/util/object_pool.hpp"
+#include "orderbook/util/huge_page_arena.hpp"
+#include "orderbook/util/wait_strategy.hpp"
 #include "orderbook/report/i_trade_repository.hpp"
+#include "orderbook/risk/i_risk_check.hpp"
 
 namespace orderbook::core {
 
 using orderbook::api::NewOrderRequest;
 using orderbook::api::ModifyOrderRequest;
+using orderbook::api::MassCancelRequest;
 using orderbook::util::IClock;
 using orderbook::util::IdGenerator;
+using orderbook::util::TimerWheel;
+using orderbook::util::ObjectPool;
+using orderbook::util::HugePageArena;
+using orderbook::util::WaitMutex;
 using orderbook::report::ITradeRepository;
+using orderbook::risk::IRiskCheck;
 
 class MatchingEngine {
 public:
-    using TradeListener = std::function<void(const std::vector<Trade>&)>;
+    using TradeListener   = std::function<void(const std::vector<Trade>&)>;
+    using TradeListenerId = std::size_t;
 
     MatchingEngine(IClock& clock, ITradeRepository& tradeRepo);
+    MatchingEngine(IClock& clock, ITradeRepository& tradeRepo, const EngineConfig& config);
+    ~MatchingEngine();
+
+    MatchingEngine(const MatchingEngine&) = delete;
+    MatchingEngine& operator=(const MatchingEngine&) = delete;
 
     orderbook::RejectReason validate_new_order(const NewOrderRequest& req) const;
     orderbook::RejectReason validate_modify_order(const Order& order, const ModifyOrderRequest& req) const;
 
     OrderId new_order(const NewOrderRequest& req);
+    // as above; reason says why INVALID_ORDER_ID was returned
+    OrderId new_order(const NewOrderRequest& req, orderbook::RejectReason& reason);
     bool cancel_order(OrderId orderId);
     bool modify_order(OrderId orderId, const ModifyOrderRequest& req);
 
-    void register_trade_listener(TradeListener listener);
+    // cancel every order selected by the request, taking each affected
+    // symbol's lock once; returns the number of orders cancelled
+    std::size_t mass_cancel(const MassCancelRequest& req);
+
+    TradeListenerId register_trade_listener(TradeListener listener);
+
+    // a publish already under way may still call the listener once
+    void remove_trade_listener(TradeListenerId id);
+
+    // pre-trade risk stage run on every new order and quantity amend;
+    // install before trading starts, nullptr disables it
+    void set_risk_check(IRiskCheck* risk);
+
+    // DAY orders expire at this time; DAY orders are rejected until it is set
+    void set_session_end(Timestamp sessionEnd);
+
+    // remove GTD / DAY orders that are due at clock.now(); runs automatically
+    // when a simulated clock moves and lazily on each request otherwise
+    void expire_orders();
+
+    // allocation algorithm of a symbol's book; takes the symbol lock
+    void set_match_algorithm(const Symbol& symbol, MatchAlgorithm algorithm);
+
+    // dynamic price band of a symbol, see PriceBand; takes the symbol lock
+    void set_price_band(const Symbol& symbol, const PriceBand& band);
+
+    // accept dark orders for a symbol; they share the pool, registry and
+    // trade stream of the lit book. Takes the symbol lock
+    void enable_dark_book(const Symbol& symbol, DarkPriority priority = DarkPriority::AfterLit);
+
+    // a halted symbol refuses new orders and amends until resumed; a band
+    // breach with BandBreachAction::Halt halts it from inside the match
+    void halt_symbol(const Symbol& symbol);
+    // false if the symbol is not halted; a halt entered during a call
+    // auction resumes the call, which only uncross_auction ends
+    bool resume_symbol(const Symbol& symbol);
+    TradingState trading_state(const Symbol& symbol) const;
+
+    // call auction: orders accumulate without matching from start_auction
+    // until uncross_auction executes them at one price and resumes
+    // continuous trading. Also the way to reopen a halted symbol
+    void start_auction(const Symbol& symbol);
+    AuctionResult indicative_uncross(const Symbol& symbol);
+    AuctionResult uncross_auction(const Symbol& symbol);
 
     OrderBook& get_or_create_book(const Symbol& symbol);
+
+    // create the books of a known instrument universe up front, so that
+    // requests for these symbols never take the directory's insert lock
+    void register_symbols(const std::vector<Symbol>& symbols);
     Symbol get_symbol_by_order(OrderId orderId) const;
 
+    // null unless EngineConfig::hugePageArenaBytes was set and no memory
+    // resource was supplied
+    const HugePageArena* memory_arena() const noexcept { return arena_.get(); }
+
 private:
-    std::unordered_map<Symbol, std::unique_ptr<OrderBook>> books_;  
-    std::unordered_map<OrderId, std::unique_ptr<Order>> ordersRegistry_;
+    static constexpr std::size_t kExpectedSymbols = 1024;
+
+    std::unique_ptr<HugePageArena> arena_;   // see EngineConfig::hugePageArenaBytes; may be null
+
+    // EngineConfig::memory, else the arena, else null for the default resource
+    std::pmr::memory_resource* memory_;
+    // registry nodes come and go with every order; pooled in front of memory_
+    // so they are recycled. Guarded by registryMutex_
+    std::unique_ptr<std::pmr::unsynchronized_pool_resource> registryPool_;
+
+    SymbolDirectory books_;   // per-symbol book + mutex, lock-free lookup
+    std::pmr::unordered_map<OrderId, Order*> ordersRegistry_;
+    ObjectPool<Order>                   orderPool_;   // guarded by registryMutex_
 
     IClock&             clock_;
     ITradeRepository&   tradeRepo_;
     IdGenerator         orderIdGenerator_;
     IdGenerator         tradeIdGenerator_;
 
-    std::vector<TradeListener> tradeListeners_;
+    std::vector<std::pair<TradeListenerId, TradeListener>> tradeListeners_;
+    TradeListenerId                                        nextTradeListenerId_{1};
+    IRiskCheck*                                            riskCheck_{nullptr};
 
-    void on_trades(const std::vector<Trade>& trades);
-    void clean_registry(const std::vector<Trade>& trades);
+    static constexpr Timestamp::duration kExpiryResolution = std::chrono::milliseconds(1);
+
+    TimerWheel                          expiryWheel_;
+    std::atomic<std::size_t>            scheduledExpiries_{0};
+    std::atomic<Timestamp::duration::rep> nextExpiryPollNs_{0};
+    std::atomic<Timestamp::duration::rep> sessionEndNs_{0};
+    IClock::ListenerId                  clockListenerId_{0};
+
+    // per-thread buffers reused across requests, see matching_engine.cpp
+    struct MatchScratch;
+    class ScratchLease;
 
-    mutable std::mutex booksMutex_;
-    mutable std::mutex registryMutex_;
-    mutable std::mutex symbolMutexesGuard_; 
-    std::unordered_map<Symbol, std::unique_ptr<std::mutex>> symbolMutexes_;
+    OrderId new_immediate_order(const NewOrderRequest& req, BookEntry& entry);
+    void init_order(Order& o, const NewOrderRequest& req);
+
+    void publish_trades(const std::vector<Trade>& trades);
+    void on_trades(const std::vector<Trade>& trades);
+    void run_triggered_stops(OrderBook& book, MatchScratch& scratch);
+    void settle(OrderBook& book, MatchScratch& scratch);
+    void to_trades(const Symbol& symbol, const FillBuffer& fills, std::vector<Trade>& trades);
+    void schedule_expiry(const Order& order);
+    void release_order(OrderId orderId);
+    void release_orders(const std::vector<Order*>& orders);
+    void poll_expiries();
+
+    mutable WaitMutex  registryMutex_;
     mutable std::mutex listenersMutex_;
-    std::mutex* get_or_create_symbol_mutex(const Symbol& symbol);  
+    mutable std::mutex expiryMutex_;
 }; 
 
 }
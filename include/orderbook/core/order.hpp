@@ -2,6 +2,7 @@
 #define ORDER_HPP
 
 #include <cstdint>
+#include <functional>
 
 #include "orderbook/types.hpp"
 #include "orderbook/util/timestamp.hpp"
@@ -12,6 +13,8 @@ using orderbook::util::Timestamp;
 
 struct Order {
     OrderId     orderId{INVALID_ORDER_ID};
+    OwnerId     owner{INVALID_OWNER_ID};
+    SelfTradePrevention stp{SelfTradePrevention::None};
     Symbol      symbol{};
     Side        side{Side::Buy};
     OrderType   type{OrderType::Limit};
@@ -22,6 +25,25 @@ struct Order {
     Quantity    filled{0};     
     Timestamp   timestamp{};   
 
+    // stop / stop-limit: held in the stop book until the trigger price trades
+    bool        isStop{false};
+    StopType    stopType{StopType::StopMarket};
+    Price       stopPrice{0.0};
+
+    // iceberg: only displayQty is shown at a time, 0 means fully displayed
+    Quantity    displayQty{0};
+
+    // pegged: while resting, price holds the offset from the peg reference
+    PegType     pegType{PegType::None};
+    Price       pegOffset{0.0};
+
+    // dark: rests in the midpoint book and only trades in executions of at least minQty
+    bool        isDark{false};
+    Quantity    minQty{0};
+
+    // GTD / DAY orders leave the book at this time
+    Timestamp   expireTime{Timestamp::time_point{}};
+
     Order() = default;
 
     Order(OrderId     id,
@@ -36,10 +58,21 @@ struct Order {
     // check if order is completely filled
     bool is_filled() const { return qty > 0 && remaining == 0; }
 
+    bool is_iceberg() const { return displayQty > 0; }
+
+    bool is_pegged() const { return pegType != PegType::None; }
+
+    bool has_expiry() const { return tif == TimeInForce::GTD || tif == TimeInForce::DAY; }
+
     // add a fill quantity, update filled / remaining
     void add_fill(Quantity q);
+
+    // reduce open quantity without a fill (self-trade decrement / cancel)
+    void reduce(Quantity q);
 };
 
+using OrderPredicate = std::function<bool(const Order&)>;
+
 } 
 
 #endif
\ No newline at end of file
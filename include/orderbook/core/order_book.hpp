@@ -1,34 +1,197 @@
 #ifndef ORDER_BOOK_HPP
 #define ORDER_BOOK_HPP
 
+#include <atomic>
+#include <memory>
+#include <memory_resource>
 #include <unordered_map>
 #include <vector>
 
 #include "orderbook/core/order.hpp"
-#include "orderbook/core/trade.hpp"
+#include "orderbook/core/fill.hpp"
 #include "orderbook/core/order_book_side.hpp"
+#include "orderbook/core/stop_book.hpp"
+#include "orderbook/core/peg_book.hpp"
+#include "orderbook/core/dark_book.hpp"
+#include "orderbook/core/book_snapshot.hpp"
+#include "orderbook/core/price_band.hpp"
+#include "orderbook/util/seq_lock.hpp"
 #include "orderbook/api/modify_order_request.hpp"
+#include "orderbook/api/mass_cancel_request.hpp"
 
 namespace orderbook::core {
 
 using orderbook::api::ModifyOrderRequest; 
+using orderbook::api::MassCancelRequest;
 
 class OrderBook {
 public:
     OrderBook();
 
-    std::vector<Trade> submit_order(Order& order);
+    // price levels, stop / peg / dark queues and depth indexes are pooled
+    // on top of upstream (a HugePageArena, monotonic buffer, ...) instead
+    // of coming from the default resource
+    explicit OrderBook(std::pmr::memory_resource* upstream);
+
+    // append the order's fills to the caller's buffer and return how many.
+    // While halted, or once a sweep reaches the price band, the unfilled
+    // remainder is cancelled (remaining set to 0) instead of resting.
+    // During an auction orders rest unmatched and those that cannot rest
+    // are cancelled
+    std::size_t submit_order(Order& order, FillBuffer& fills);
 
     bool cancel_order(Order& order);
 
     bool modify_order(Order& order, const ModifyOrderRequest& req);
 
+    // unlink resting and pending stop orders matching pred in one sweep
+    std::size_t remove_orders_if(const OrderPredicate& pred, std::vector<Order*>& removed);
+
+    // unlink every order selected by the request's side / price / owner
+    // filters (the symbol filter is the caller's), level by level
+    std::size_t cancel_orders(const MassCancelRequest& req, std::vector<Order*>& removed);
+
+    // remove the candidates (orders fired by the expiry timer) whose expire
+    // time has passed; large batches such as end-of-day DAY expiry are
+    // swept level-by-level rather than unlinked one at a time
+    void expire_orders(const std::vector<Order*>& candidates, Timestamp now, std::vector<Order*>& expired);
+
+    std::size_t order_count() const noexcept
+    {
+        return bids_.order_count() + asks_.order_count() + stops_.size() + pegs_.order_count()
+             + (dark_ ? dark_->order_count() : 0);
+    }
+
+    // pop stops fired by the trades since the last call; each must be fed
+    // back through submit_order, which may fire further stops (cascade)
+    void collect_triggered_stops(std::vector<Order*>& out);
+
+    // pop resting orders fully filled since the last call; the incoming
+    // order itself is never reported, its submitter checks remaining
+    void collect_filled_orders(std::vector<Order*>& out);
+
+    // pop resting orders cancelled by self-trade prevention since the last call
+    void collect_cancelled_orders(std::vector<Order*>& out);
+
+    // market-by-price depth of both sides into caller arrays of n entries;
+    // reads live state, so callers must hold the symbol lock
+    DepthSummary depth(DepthLevel* bids, DepthLevel* asks, std::size_t n, bool cumulative = false) const;
+
+    // consistent top-of-book copy as of the last completed mutation; safe to
+    // call from any thread without the symbol lock and never blocks matching
+    BookSnapshot snapshot() const noexcept { return snapshot_.load(); }
+    BookTouch touch() const noexcept { return touch_.load(); }
+
+    // bids() / asks() / stops() read live state: callers must hold the symbol lock
     const OrderBookSide& bids() const noexcept { return bids_; }
     const OrderBookSide& asks() const noexcept { return asks_; }
+    const StopBook& stops() const noexcept { return stops_; }
+    const PegBook& pegs() const noexcept { return pegs_; }
+    const DarkBook* dark() const noexcept { return dark_.get(); }
+
+    // add a midpoint dark book; books without one pay a null check per order.
+    // has_dark_book() is readable without the symbol lock
+    void enable_dark_book(DarkPriority priority = DarkPriority::AfterLit);
+    bool has_dark_book() const noexcept { return darkEnabled_.load(std::memory_order_acquire); }
+
+    // 0.0 until the first trade
+    Price last_trade_price() const noexcept { return lastTradePrice_; }
+
+    // allocation policy of the match loop, Fifo by default
+    void set_match_algorithm(MatchAlgorithm algorithm) { matchAlgorithm_ = algorithm; }
+    MatchAlgorithm match_algorithm() const noexcept { return matchAlgorithm_; }
+
+    void set_price_band(const PriceBand& band);
+    const PriceBand& price_band() const noexcept { return band_; }
+
+    // readable without the symbol lock; halt() / resume() need it
+    TradingState trading_state() const noexcept { return state_.load(std::memory_order_acquire); }
+    void halt();
+
+    // lift a halt, back to the phase it interrupted (see TradingState);
+    // false if the book is not halted
+    bool resume();
+
+    // enter the call phase, from continuous trading or a halt
+    void start_auction();
+
+    // price and volume the book would uncross at now
+    AuctionResult indicative_uncross() const;
+
+    // execute the auction at the uncrossing price, every fill at that
+    // price in price-time priority per side, and return to continuous trading
+    AuctionResult uncross(FillBuffer& fills);
 
 private:
+    // recycles the book's container blocks; only with an upstream resource
+    std::unique_ptr<std::pmr::unsynchronized_pool_resource> pool_;
+    std::pmr::memory_resource*                              memory_;
+
     OrderBookSide bids_;
     OrderBookSide asks_;
+    StopBook      stops_;
+    PegBook       pegs_;
+
+    std::unique_ptr<DarkBook> dark_;
+    DarkPriority              darkPriority_{DarkPriority::AfterLit};
+    std::atomic<bool>         darkEnabled_{false};
+
+    std::vector<Order*> filledOrders_;
+    std::vector<Order*> cancelledOrders_;
+
+    // sweep instead of unlinking one by one once a batch is 1/kSweepRatio of the book
+    static constexpr std::size_t kSweepRatio = 8;
+
+    Price lastTradePrice_{0.0};
+
+    // uncross scratch, reused across auctions
+    mutable std::vector<AuctionLevel> auctionBidLevels_;
+    mutable std::vector<AuctionLevel> auctionAskLevels_;
+    std::vector<AuctionAllocation>    auctionBuys_;
+    std::vector<AuctionAllocation>    auctionSells_;
+    std::vector<AuctionAllocation>    pegAllocations_;
+
+    MatchAlgorithm            matchAlgorithm_{MatchAlgorithm::Fifo};
+    PriceBand                 band_;
+    std::atomic<TradingState> state_{TradingState::Continuous};
+    TradingState              haltedFrom_{TradingState::Continuous};   // what resume() returns to
+
+    orderbook::util::SeqLock<BookSnapshot> snapshot_;
+    orderbook::util::SeqLock<BookTouch>    touch_;
+    std::uint64_t snapshotVersion_{0};
+
+    // trade price range not yet checked against the stop book
+    Price pendingLow_{0.0};
+    Price pendingHigh_{0.0};
+    bool  hasPendingTrades_{false};
+
+    bool is_stop_triggered(const Order& order) const;
+
+    // match against the opposite side with this book's allocation policy
+    bool match_order(OrderBookSide& opposite, Order& order, FillBuffer& fills, Price bandLimit);
+
+    // match against the limit side and the pegs in price order, pegs priced
+    // off touch; only called while the opposite side has pegs
+    bool match_with_pegs(Order& order, FillBuffer& fills, Price bandLimit, const BookTouch& touch);
+    Quantity peg_quantity_for_order(const Order& order, const BookTouch& touch, bool banded, Price bandLimit) const;
+
+    // a dark order crosses the other dark side at the midpoint, then rests
+    std::size_t submit_dark_order(Order& order, FillBuffer& fills);
+
+    // cross order with the opposite dark side at the current lit midpoint
+    void match_dark(Order& order, FillBuffer& fills);
+
+    // trade resting buy pegs against sell pegs the touch has pushed through them
+    void uncross_pegs(FillBuffer& fills);
+
+    // best limit prices, 0.0 for an empty side
+    BookTouch limit_touch() const;
+
+    // furthest price an incoming order of side may trade at; false, with
+    // limit +-inf, while no band applies (disabled or no reference price yet)
+    bool band_limit(Side side, Price& limit) const;
+    void record_fills(const FillBuffer& fills, std::size_t first);
+    void publish_snapshot();
 
     OrderBookSide& side_of(Side side);
     const OrderBookSide& side_of(Side side) const;
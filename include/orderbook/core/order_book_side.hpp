@@ -2,17 +2,23 @@
 #define ORDER_BOOK_SIDE_HPP
 
 #include <map>
+#include <memory_resource>
 #include <vector>
 
 #include "orderbook/core/order.hpp"
-#include "orderbook/core/trade.hpp"
+#include "orderbook/core/fill.hpp"
 #include "orderbook/core/price_level.hpp"
+#include "orderbook/core/depth_level.hpp"
+#include "orderbook/core/depth_index.hpp"
+#include "orderbook/core/auction.hpp"
+#include "orderbook/core/match_policy.hpp"
 
 namespace orderbook::core {
 
 class OrderBookSide {
 public:
-    explicit OrderBookSide(Side side);
+    // levels, their queues and the depth index are allocated from resource
+    explicit OrderBookSide(Side side, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
     Side side() const noexcept { return side_; }
 
@@ -20,26 +26,113 @@ public:
 
     bool remove_order(const Order& order);
 
-    void match(Order& incoming, std::vector<Trade>& trades);
+    // size-down amend: the order keeps its place in the queue, see PriceLevel::reduce_order
+    bool reduce_order(const Order& order, Quantity qty);
 
+    // bulk removal: one pass over all levels instead of a queue scan per order
+    std::size_t remove_orders_if(const OrderPredicate& pred, std::vector<Order*>& removed);
+
+    // same, limited to levels priced within [minPrice, maxPrice];
+    // an empty pred takes whole levels without inspecting the orders
+    std::size_t remove_orders_if(Price minPrice, Price maxPrice, const OrderPredicate& pred, std::vector<Order*>& removed);
+
+    // fills are appended to the caller's buffer, fully filled resting orders
+    // to completed and resting orders removed by self-trade prevention to cancelled.
+    // The sweep never enters a level beyond bandLimit (checked once per level);
+    // returns true if it stopped there with quantity left. Policy decides how
+    // a level is shared, see match_policy.hpp; instantiated for the policies there.
+    // A pegged side keys its levels by offset: reference turns them into prices
+    template <typename Policy>
+    bool match(Order& incoming, FillBuffer& fills, std::vector<Order*>& completed, std::vector<Order*>& cancelled,
+               Price bandLimit, Price reference = 0.0);
+
+    // O(log n): executable quantity within the incoming order's limit (whole side for market)
     Quantity available_quantity_for_order(const Order& incoming) const;
 
+    // executable quantity (displayed and iceberg reserve) priced at or better than price
+    Quantity depth_to_price(Price price) const;
+
+    // worst price reached when taking qty from this side; false if the side holds less
+    bool price_for_quantity(Quantity qty, Price& worstPrice) const;
+
+    // executable quantity on the whole side
+    Quantity total_quantity() const noexcept { return depthIndex_.total(); }
+
+    // every level in ascending price order with its executable quantity
+    void auction_levels(std::vector<AuctionLevel>& out) const;
+
+    // take qty from the best levels in priority order for an uncross; each
+    // order's share goes to out, fully filled orders to completed. The side
+    // must hold qty priced at or better than the uncrossing price
+    void execute_auction(Quantity qty, std::vector<AuctionAllocation>& out, std::vector<Order*>& completed);
+
     PriceLevel* best_level();
     const PriceLevel* best_level() const;
 
-    std::vector<PriceLevel*> top_k_levels(std::size_t k);
     std::vector<const PriceLevel*> top_k_levels(std::size_t k) const;
 
+    // fill out with up to n levels, best first, in one walk and without
+    // allocating; returns how many were written. cumulative makes each
+    // entry's quantity / orderCount a running total from the best level
+    std::size_t depth(DepthLevel* out, std::size_t n, bool cumulative = false) const;
+
+    std::size_t order_count() const noexcept { return orderCount_; }
+
 private:
-    using PriceLevels = std::map<double, PriceLevel>;
+    using PriceLevels = std::pmr::map<double, PriceLevel>;
 
     Side   side_;
     PriceLevels priceLevels_;
+    std::size_t orderCount_{0};
+
+    // cumulative executable quantity by price, kept in step with the levels
+    DepthIndex depthIndex_;
+
+    // fills owed to resting orders, applied once the sweep is done so the
+    // loop stays on the hot records; reused across calls
+    struct PendingFill {
+        Order*   order;
+        Quantity qty;
+    };
+    std::vector<PendingFill> pendingFills_;
+
+    AllocationScratch allocation_;
+
+    // share all of incoming's remaining quantity, less than the level's
+    // displayed volume, across the level in the policy's two passes
+    template <typename Policy>
+    void allocate_level(Order& incoming, PriceLevels::iterator it, Price price, FillBuffer& fills,
+                        std::vector<Order*>& completed);
+
+    static bool level_has_owner(const PriceLevel& level, OwnerId owner);
 
     PriceLevels::iterator       best_level_it();
     PriceLevels::const_iterator best_level_it() const;
 
     void clean_side(PriceLevels::iterator it);
+
+    void index_delta(Price price, Quantity delta);
+    void rebuild_depth_index(Price price);
+
+    // quantity of the levels priced below price, or at or below it when inclusive
+    Quantity quantity_below(Price price, bool inclusive) const;
+
+    // call fn on up to k non-empty levels, best first
+    template <typename Fn>
+    void for_each_best_level(std::size_t k, Fn&& fn) const
+    {
+        std::size_t n = 0;
+        if (side_ == Side::Buy) {
+            for (auto it = priceLevels_.rbegin(); it != priceLevels_.rend() && n < k; ++it) {
+                if (!it->second.empty()) { fn(it->second); ++n; }
+            }
+        }
+        else {
+            for (auto it = priceLevels_.begin(); it != priceLevels_.end() && n < k; ++it) {
+                if (!it->second.empty()) { fn(it->second); ++n; }
+            }
+        }
+    }
 };
 
 } 
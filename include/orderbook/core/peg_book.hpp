@@ -0,0 +1,52 @@
+#ifndef PEG_BOOK_HPP
+#define PEG_BOOK_HPP
+
+#include <array>
+#include <vector>
+
+#include "orderbook/types.hpp"
+#include "orderbook/core/order.hpp"
+#include "orderbook/core/order_book_side.hpp"
+#include "orderbook/core/book_snapshot.hpp"
+
+namespace orderbook::core {
+
+// Resting pegged orders of one book. Each side and peg type is an
+// OrderBookSide keyed by offset instead of price: a group's price is the
+// peg reference plus its key, worked out only when matching reaches it,
+// so a top-of-book move reprices nothing however many pegs rest. Resting
+// pegs keep their offset in Order::price.
+class PegBook {
+public:
+    static constexpr std::size_t kTypes = 3;
+
+    explicit PegBook(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    OrderBookSide& side(Side side, PegType type);
+    const OrderBookSide& side(Side side, PegType type) const;
+
+    bool empty() const noexcept { return order_count() == 0; }
+    bool empty(Side side) const noexcept { return order_count(side) == 0; }
+    std::size_t order_count() const noexcept { return order_count(Side::Buy) + order_count(Side::Sell); }
+    std::size_t order_count(Side side) const noexcept;
+
+    void add_order(Order* order);
+    bool remove_order(const Order& order);
+    std::size_t remove_orders_if(const OrderPredicate& pred, std::vector<Order*>& removed);
+
+    // price the pegs of type on side follow, from the limit book's touch
+    // (0.0 = empty side); false while that reference is undefined
+    static bool reference(PegType type, Side side, const BookTouch& touch, Price& out);
+
+    // best priced group on side over all peg types; false if none is priced
+    bool best(Side side, const BookTouch& touch, PegType& type, Price& price) const;
+
+private:
+    std::array<OrderBookSide, kTypes> bids_;
+    std::array<OrderBookSide, kTypes> asks_;
+    static std::size_t index_of(PegType type) { return static_cast<std::size_t>(type) - 1; }
+};
+
+}
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef PRICE_BAND_HPP
+#define PRICE_BAND_HPP
+
+#include "orderbook/types.hpp"
+
+namespace orderbook::core {
+
+enum class BandBreachAction {
+    CancelRemainder,   // stop the sweep and cancel what is left of the order
+    Halt               // same, and halt the symbol until resumed
+};
+
+// Dynamic price band of one symbol: no trade may print further than percent
+// from the reference price, which is the last trade or, before the first
+// trade, referencePrice (e.g. the previous close). Both the band and the
+// reference are taken once per incoming order, not per fill.
+struct PriceBand {
+    double           percent{0.0};          // 0.05 = 5%, 0 disables the band
+    Price            referencePrice{0.0};   // used until the first trade
+    BandBreachAction onBreach{BandBreachAction::CancelRemainder};
+
+    bool enabled() const noexcept { return percent > 0.0; }
+};
+
+}
+
+#endif
@@ -1,34 +1,86 @@
 #ifndef PRICE_LEVEL_HPP
 #define PRICE_LEVEL_HPP
 
+#include <cstdint>
 #include <deque>
+#include <memory_resource>
+#include <vector>
 
 #include "orderbook/types.hpp"
 #include "orderbook/core/order.hpp"
 
 namespace orderbook::core {
 
+// Hot per-order record kept in the level queue. Matching a plain order reads
+// and writes only this; the full Order (symbol, timestamps, ...) is touched
+// for icebergs, self-trade checks that hit and when fills are applied.
+struct RestingOrder {
+    static constexpr std::uint32_t kIceberg = 1u << 0;
+
+    OrderId       orderId{INVALID_ORDER_ID};
+    Quantity      visible{0};   // displayed part of remaining
+    Order*        order{nullptr};
+    OwnerId       owner{INVALID_OWNER_ID};
+    std::uint32_t flags{0};
+
+    bool is_iceberg() const { return (flags & kIceberg) != 0; }
+};
+
+static_assert(sizeof(RestingOrder) <= 32, "RestingOrder must stay within half a cache line");
+
 class PriceLevel {
 public:
-    using OrdersQueue = std::deque<Order*>;
+    using OrdersQueue    = std::pmr::deque<RestingOrder>;
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
 
-    explicit PriceLevel(Price price = 0.0);
+    // the queue's blocks come from alloc's resource; a pmr map of levels
+    // passes its own down when it creates the level
+    explicit PriceLevel(Price price = 0.0, const allocator_type& alloc = {});
 
     void add_order(Order* o);
 
     Order* top_order(); 
     const Order* top_order() const;
 
+    // hot record of the order at the front of the queue, level must not be empty
+    RestingOrder& front() { return ordersQueue_.front(); }
+    const RestingOrder& front() const { return ordersQueue_.front(); }
+
     void remove_top_order();
 
+    // show the next peak of the (iceberg) top order and move it to the back
+    void replenish_top_order();
+
     bool remove_order(OrderId orderId);
 
+    // take qty off a resting order in place, keeping its queue position; an
+    // iceberg loses reserve before display. qty must be less than the order's
+    // remaining quantity, which the caller reduces afterwards
+    bool reduce_order(OrderId orderId, Quantity qty);
+
+    // unlink every order matching pred in a single pass, keeping queue order
+    std::size_t remove_orders_if(const OrderPredicate& pred, std::vector<Order*>& removed);
+
+    // unlink every order, leaving the level empty
+    std::size_t remove_all_orders(std::vector<Order*>& removed);
+
+    // after an allocation filled orders in the middle of the queue: unlink
+    // the entries left with nothing displayed, reporting those with nothing
+    // remaining in completed, and requeue iceberg peaks at the back in
+    // queue order; returns the number of orders unlinked
+    std::size_t remove_exhausted(std::vector<Order*>& completed, std::vector<RestingOrder>& requeue);
+
     void update_volume(Quantity filledQty);
 
     Price price() const { return price_; }
 
+    // displayed quantity only, this is what L2 data reports
     Quantity volume() const { return volume_; }
 
+    Quantity hidden_volume() const { return hiddenVolume_; }
+
+    Quantity total_volume() const { return volume_ + hiddenVolume_; }
+
     OrdersQueue& orders() { return ordersQueue_; }
     const OrdersQueue& orders() const { return ordersQueue_; }
 
@@ -38,9 +90,16 @@ public:
 private:
     Price       price_;
     Quantity    volume_;
+    Quantity    hiddenVolume_;
     OrdersQueue ordersQueue_;
+
+    // reserve behind the displayed peak; only icebergs have one
+    static Quantity hidden_of(const RestingOrder& r)
+    {
+        return r.is_iceberg() ? r.order->remaining - r.visible : 0;
+    }
 };
 
 } 
 
-#endif 
\ No newline at end of file
+#endif 
@@ -0,0 +1,46 @@
+#ifndef STOP_BOOK_HPP
+#define STOP_BOOK_HPP
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory_resource>
+#include <vector>
+
+#include "orderbook/types.hpp"
+#include "orderbook/core/order.hpp"
+
+namespace orderbook::core {
+
+// Pending stop / stop-limit orders of one symbol, indexed by trigger price.
+// Each side is sorted so that the next stop to fire sits at begin(), which
+// keeps the per-trade check O(1) and activation O(triggered).
+class StopBook {
+public:
+    explicit StopBook(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : buyStops_(resource), sellStops_(resource) {}
+
+    void add_order(Order* order);
+
+    bool remove_order(const Order& order);
+
+    std::size_t remove_orders_if(const OrderPredicate& pred, std::vector<Order*>& removed);
+
+    // move every stop crossed by a trade in [low, high] into out,
+    // buy stops fire on high >= stopPrice, sell stops on low <= stopPrice
+    void collect_triggered(Price low, Price high, std::vector<Order*>& out);
+
+    bool empty() const { return size_ == 0; }
+    std::size_t size() const { return size_; }
+
+private:
+    using StopQueue = std::pmr::deque<Order*>;
+
+    std::pmr::map<Price, StopQueue>                      buyStops_;   // ascending: lowest trigger first
+    std::pmr::map<Price, StopQueue, std::greater<Price>> sellStops_;  // descending: highest trigger first
+    std::size_t size_{0};
+};
+
+}
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef SYMBOL_DIRECTORY_HPP
+#define SYMBOL_DIRECTORY_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+#include "orderbook/types.hpp"
+#include "orderbook/core/order_book.hpp"
+#include "orderbook/util/wait_strategy.hpp"
+
+namespace orderbook::core {
+
+// Everything the engine keeps per symbol, in one place: the book and the
+// lock that serializes its mutations.
+struct BookEntry {
+    BookEntry(Symbol sym, orderbook::util::WaitStrategy lockWait, std::pmr::memory_resource* memory = nullptr)
+        : symbol(std::move(sym)), mutex(lockWait), book(memory) {}
+
+    const Symbol              symbol;
+    orderbook::util::WaitMutex mutex;
+    OrderBook                 book;
+};
+
+// Symbol -> BookEntry map with lock-free lookups and locked inserts.
+// Entries are never removed, so a looked-up entry stays valid for the
+// directory's lifetime. The index is an open-addressed table of atomic
+// entry pointers; inserts fill a slot in place and only a resize copies
+// the table, publishing the new one with a single pointer swap. Replaced
+// tables are kept until destruction because readers may still be probing
+// them; with doubling they total less than the live table.
+class SymbolDirectory {
+public:
+    // upstream resource of a new symbol's book, nullptr for the default
+    using BookMemory = std::function<std::pmr::memory_resource*(const Symbol&)>;
+
+    // lockWait is how callers of each entry's mutex wait for it; memory
+    // picks the resource each book pools its containers on
+    explicit SymbolDirectory(std::size_t expectedSymbols = 64,
+                             orderbook::util::WaitStrategy lockWait = orderbook::util::WaitStrategy::Blocking,
+                             BookMemory memory = {});
+    ~SymbolDirectory();
+
+    SymbolDirectory(const SymbolDirectory&) = delete;
+    SymbolDirectory& operator=(const SymbolDirectory&) = delete;
+
+    // lock-free; nullptr if the symbol was never registered
+    BookEntry* find(const Symbol& symbol) const noexcept;
+
+    // lock-free when present, takes the insert lock otherwise
+    BookEntry& get_or_create(const Symbol& symbol);
+
+    // register a batch under one lock, e.g. the instrument universe at startup
+    void reserve_symbols(const std::vector<Symbol>& symbols);
+
+    // visit every entry registered so far
+    void for_each(const std::function<void(BookEntry&)>& fn) const;
+
+    std::size_t size() const noexcept { return size_.load(std::memory_order_acquire); }
+
+private:
+    struct Table {
+        explicit Table(std::size_t capacity);
+
+        std::size_t mask;
+        std::unique_ptr<std::atomic<BookEntry*>[]> slots;
+    };
+
+    std::atomic<Table*>                     table_;
+    std::atomic<std::size_t>                size_{0};
+    const orderbook::util::WaitStrategy     lockWait_;
+    const BookMemory                        memory_;
+
+    std::mutex                              insertMutex_;
+    std::vector<std::unique_ptr<Table>>     tables_;    // current one last
+    std::vector<std::unique_ptr<BookEntry>> entries_;   // registration order
+
+    BookEntry& insert_locked(const Symbol& symbol);
+    void grow_locked();
+
+    static BookEntry* probe(const Table& table, const Symbol& symbol, std::size_t hash) noexcept;
+};
+
+}
+
+#endif
@@ -1,9 +1,13 @@
 #ifndef INTERNAL_TRADE_REPOSITORY_HPP
 #define INTERNAL_TRADE_REPOSITORY_HPP
 
-#include <vector>
-#include <unordered_map>
+#include <functional>
+#include <memory_resource>
 #include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 #include "orderbook/report/i_trade_repository.hpp"
 
@@ -11,6 +15,11 @@ namespace orderbook::report {
 
 class InternalTradeRepository : public ITradeRepository {
 public:
+    // everything stored, symbols included, is allocated from resource,
+    // which must outlive the repository
+    explicit InternalTradeRepository(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : tradesBySymbol_(resource) {}
+
     void add_trades(const std::vector<Trade>& trades) override;
 
     std::vector<Trade> trades_between(const Symbol& symbol, Timestamp start, Timestamp end) override;
@@ -18,10 +27,31 @@ public:
     std::vector<Trade> trades_all(const Symbol& symbol) override;
 
 private:
-    std::unordered_map<Symbol, std::vector<Trade>> tradesBySymbol_;  
-    std::mutex mutex_;
+    // a trade without its symbol, which the map key holds once
+    struct StoredTrade {
+        TradeId   tradeId;
+        OrderId   buyOrderId;
+        OrderId   sellOrderId;
+        Price     price;
+        Quantity  quantity;
+        Timestamp timestamp;
+    };
+
+    // lets a Symbol look up a pmr key without building one
+    struct SymbolHash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+    };
+
+    using TradesBySymbol = std::pmr::unordered_map<std::pmr::string, std::pmr::vector<StoredTrade>,
+                                                   SymbolHash, std::equal_to<>>;
+
+    TradesBySymbol tradesBySymbol_;
+    std::mutex     mutex_;
+
+    static Trade to_trade(const Symbol& symbol, const StoredTrade& t);
 };
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,77 @@
+#ifndef ACCOUNT_RISK_MANAGER_HPP
+#define ACCOUNT_RISK_MANAGER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "orderbook/risk/i_risk_check.hpp"
+#include "orderbook/risk/risk_limits.hpp"
+#include "orderbook/util/seq_lock.hpp"
+
+namespace orderbook::risk {
+
+// Lock-free per-account limits. Each account's counters sit on their own
+// cache line and are updated with atomic reserve / roll-back, so checks on
+// different accounts never contend and checks on one account never block.
+// Exposure is counted pessimistically: open orders count as if fully filled
+// until they close, so fills need no callback.
+// Orders from accounts that were never registered are rejected.
+class AccountRiskManager : public IRiskCheck {
+public:
+    struct AccountView {
+        std::int64_t position{0};     // net filled quantity of closed orders, buys positive
+        std::int64_t openBuy{0};      // order quantity of open buy orders
+        std::int64_t openSell{0};
+        std::int64_t openOrders{0};
+    };
+
+    explicit AccountRiskManager(std::size_t maxAccounts = 1024);
+    ~AccountRiskManager() override;
+
+    AccountRiskManager(const AccountRiskManager&) = delete;
+    AccountRiskManager& operator=(const AccountRiskManager&) = delete;
+
+    // register an account or replace its limits; safe while trading.
+    // false when maxAccounts accounts are already registered
+    bool set_limits(OwnerId owner, const RiskLimits& limits);
+
+    bool account(OwnerId owner, AccountView& out) const;
+
+    RejectReason check_new_order(const NewOrderRequest& req, const OrderBook& book) override;
+    RejectReason check_resize(OwnerId owner, Side side, Price price, Quantity oldQty, Quantity newQty) override;
+    void release_resize(OwnerId owner, Side side, Quantity oldQty, Quantity newQty) override;
+    void on_order_closed(OwnerId owner, Side side, Quantity qty, Quantity filled) override;
+
+private:
+    struct alignas(64) Account {
+        explicit Account(OwnerId id) : owner(id) {}
+
+        const OwnerId                   owner;
+        orderbook::util::SeqLock<RiskLimits> limits;
+
+        // written by every order of the account, kept off the limits' line
+        alignas(64) std::atomic<std::int64_t> openOrders{0};
+        std::atomic<std::int64_t>       openBuy{0};
+        std::atomic<std::int64_t>       openSell{0};
+        std::atomic<std::int64_t>       position{0};
+    };
+
+    std::size_t                               mask_;
+    std::unique_ptr<std::atomic<Account*>[]>  slots_;
+    std::size_t                               maxAccounts_;
+
+    std::mutex                                insertMutex_;
+    std::vector<std::unique_ptr<Account>>     accounts_;
+
+    Account* find(OwnerId owner) const noexcept;
+
+    // reserve qty more exposure on side, checked against the position limit
+    static bool reserve_exposure(Account& a, Side side, Quantity qty, Quantity maxPosition);
+};
+
+}
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef I_RISK_CHECK_HPP
+#define I_RISK_CHECK_HPP
+
+#include "orderbook/types.hpp"
+#include "orderbook/api/new_order_request.hpp"
+#include "orderbook/core/order_book.hpp"
+
+namespace orderbook::risk {
+
+using orderbook::api::NewOrderRequest;
+using orderbook::core::OrderBook;
+
+// Pre-trade risk stage plugged into MatchingEngine. The checks run before
+// the symbol lock is taken and may be called from many threads at once;
+// the book may only be read through its lock-free snapshot / touch. Exposure of an
+// accepted order stays reserved until on_order_closed.
+class IRiskCheck {
+public:
+    virtual ~IRiskCheck() = default;
+
+    // reserve the order's exposure or say why it is rejected
+    virtual RejectReason check_new_order(const NewOrderRequest& req, const OrderBook& book) = 0;
+
+    // reserve (or give back) the exposure of a quantity change on a live order
+    virtual RejectReason check_resize(OwnerId owner, Side side, Price price, Quantity oldQty, Quantity newQty) = 0;
+
+    // undo an accepted check_resize(owner, side, price, oldQty, newQty) of an
+    // amend that then failed; checks nothing and cannot fail
+    virtual void release_resize(OwnerId owner, Side side, Quantity oldQty, Quantity newQty) = 0;
+
+    // an accepted order left the engine: filled, cancelled, expired or its
+    // unfilled remainder dropped; qty is its final order quantity
+    virtual void on_order_closed(OwnerId owner, Side side, Quantity qty, Quantity filled) = 0;
+};
+
+}
+
+#endif
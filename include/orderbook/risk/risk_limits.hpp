@@ -0,0 +1,22 @@
+#ifndef RISK_LIMITS_HPP
+#define RISK_LIMITS_HPP
+
+#include <cstdint>
+
+#include "orderbook/types.hpp"
+
+namespace orderbook::risk {
+
+// Per-account pre-trade limits; 0 disables a limit.
+struct RiskLimits {
+    Quantity      maxOrderQuantity{0};
+    double        maxOrderNotional{0.0};   // price x quantity of a single order
+    std::uint32_t maxOpenOrders{0};
+    Quantity      maxPosition{0};          // |net position| if every open order filled
+    double        priceCollar{0.0};        // max distance of a limit price from the
+                                           // reference price, as a fraction (0.05 = 5%)
+};
+
+}
+
+#endif
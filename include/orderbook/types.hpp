@@ -11,6 +11,7 @@ using TradeId = std::uint64_t;
 using Price = double; 
 using Quantity = std::int64_t;
 using Symbol = std::string;
+using OwnerId = std::uint32_t;  // account / session the order belongs to
 
 enum class Side {
     Buy,
@@ -25,24 +26,85 @@ enum class OrderType {
 enum class TimeInForce {
     GTC, // Good Till Cancelled
     IOC, // Immediate Or Cancel
-    FOK  // Fill Or Kill
+    FOK, // Fill Or Kill
+    GTD, // Good Till Date, expires at the order's expire time
+    DAY  // expires at the engine's session end
 };
 
+// whether the unfilled remainder of an order rests on the book
+constexpr bool rests_on_book(TimeInForce tif)
+{
+    return tif == TimeInForce::GTC || tif == TimeInForce::GTD || tif == TimeInForce::DAY;
+}
+
 enum class StopType {
     StopMarket,
     StopLimit
 };
 
+// price a pegged limit order tracks, plus its offset; pegs are not displayed
+enum class PegType {
+    None,
+    Primary,    // same side touch: buys follow the best bid, sells the best ask
+    Market,     // opposite touch: buys follow the best ask, sells the best bid
+    Midpoint    // middle of the best bid and ask
+};
+
+// applied when an incoming order would trade against a resting order of
+// the same owner; the incoming order's mode decides
+enum class SelfTradePrevention {
+    None,           // allow the trade
+    CancelResting,  // cancel the resting order, keep matching
+    CancelIncoming, // cancel the rest of the incoming order
+    CancelBoth,     // cancel both
+    Decrement       // reduce both by the smaller quantity without trading
+};
+
+// how a price level is shared between resting orders, chosen per symbol
+enum class MatchAlgorithm {
+    Fifo,              // price-time priority
+    ProRata,           // in proportion to displayed size
+    ProRataTopOrder,   // front order first, then pro-rata
+    SizeTime           // largest displayed order first, then time
+};
+
+// per-symbol trading phase. Transitions:
+//   Continuous -> Halted     halt, or a band breach with BandBreachAction::Halt
+//   Continuous -> Auction    start_auction
+//   Halted     -> Auction    start_auction
+//   Halted     -> (before)   resume: back to the phase the halt interrupted
+//   Auction    -> Halted     halt; resume returns to the call
+//   Auction    -> Continuous uncross only: orders collected in the call may
+//                            cross, so resume cannot leave a call
+enum class TradingState {
+    Continuous,
+    Halted,         // no matching; new orders and amends are refused, cancels allowed
+    Auction         // call phase: resting orders accumulate unmatched until the uncross
+};
+
 enum class RejectReason {
     None,
     InvalidPrice,
     InvalidQuantity,
     UnsupportedOrderType,
-    UnsupportedTimeInForce
+    UnsupportedTimeInForce,
+    InvalidExpireTime,
+    // pre-trade risk
+    UnknownAccount,
+    ExceedsMaxOrderQuantity,
+    ExceedsMaxNotional,
+    ExceedsMaxOpenOrders,
+    ExceedsPositionLimit,
+    PriceOutsideCollar,
+    SymbolHalted,
+    NotAllowedInAuction,    // orders that cannot rest (market, IOC, FOK) or pegs during a call
+    InvalidPegOffset,       // a primary / market peg offset that would lock or cross the touch
+    DarkBookDisabled        // a dark order for a symbol without a dark book
 };
 
 // invalid identifiers/values
 static constexpr OrderId   INVALID_ORDER_ID = 0;
 static constexpr TradeId   INVALID_TRADE_ID = 0;
+static constexpr OwnerId   INVALID_OWNER_ID = 0;
 
 }
\ No newline at end of file
@@ -0,0 +1,24 @@
+#ifndef DETACHED_TASK_HPP
+#define DETACHED_TASK_HPP
+
+#include <coroutine>
+#include <exception>
+
+namespace orderbook::util {
+
+// Return type of a fire-and-forget coroutine: it starts running when
+// called and frees its own frame when it finishes. An exception escaping
+// the coroutine terminates the program, as from a thread function.
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+}
+
+#endif
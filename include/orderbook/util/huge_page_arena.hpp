@@ -0,0 +1,72 @@
+#ifndef HUGE_PAGE_ARENA_HPP
+#define HUGE_PAGE_ARENA_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+
+namespace orderbook::util {
+
+enum class HugePageSize {
+    Size2MB,
+    Size1GB
+};
+
+// what the arena actually got from the OS
+enum class PageBacking {
+    Explicit,      // reserved huge pages (hugetlbfs / large pages)
+    Transparent,   // normal mapping advised for transparent huge pages
+    Normal         // plain pages
+};
+
+// One contiguous region mapped at construction, on huge pages when the OS
+// has them and on normal pages otherwise, optionally pre-faulted so that
+// nothing allocated from it page-faults later. Allocation is a lock-free
+// bump of an offset; deallocation is a no-op and the memory returns when
+// the arena dies, so put a pool (ObjectPool, unsynchronized_pool_resource)
+// in front of anything that frees and reallocates. Requests that no longer
+// fit go to upstream. Safe to allocate from several threads.
+class HugePageArena : public std::pmr::memory_resource {
+public:
+    explicit HugePageArena(std::size_t bytes,
+                           HugePageSize pageSize = HugePageSize::Size2MB,
+                           bool prefault = true,
+                           std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    ~HugePageArena() override;
+
+    HugePageArena(const HugePageArena&) = delete;
+    HugePageArena& operator=(const HugePageArena&) = delete;
+
+    PageBacking backing() const noexcept { return backing_; }
+    std::size_t capacity() const noexcept { return capacity_; }
+    std::size_t used() const noexcept { return std::min(offset_.load(std::memory_order_relaxed), capacity_); }
+
+    // requests served by upstream because the region was full
+    std::size_t overflow_count() const noexcept { return overflows_.load(std::memory_order_relaxed); }
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    bool owns(const void* p) const noexcept
+    {
+        const auto* b = static_cast<const std::byte*>(p);
+        return b >= base_ && b < base_ + capacity_;
+    }
+
+    std::byte*                 base_{nullptr};
+    std::size_t                capacity_{0};
+    std::size_t                mappedBytes_{0};   // what to hand back to the OS
+    void*                      mapping_{nullptr};
+    PageBacking                backing_{PageBacking::Normal};
+    std::pmr::memory_resource* upstream_;
+
+    alignas(64) std::atomic<std::size_t> offset_{0};
+    std::atomic<std::size_t>             overflows_{0};
+};
+
+}
+
+#endif
@@ -1,16 +1,27 @@
 #ifndef ICLOCK_HPP
 #define ICLOCK_HPP
 
-#include "orderbook/util/Timestamp.hpp"
+#include <cstddef>
+#include <functional>
+
+#include "orderbook/util/timestamp.hpp"
 
 namespace orderbook::util {
 
     class IClock {
     public:
+        using TimeListener = std::function<void(const Timestamp&)>;
+        using ListenerId   = std::size_t;
+
         virtual ~IClock();
         virtual Timestamp now() const = 0;
+
+        // clocks whose time jumps (e.g. simulated time) notify listeners after
+        // each change; wall clocks do not and are polled instead
+        virtual ListenerId add_time_listener(TimeListener listener);
+        virtual void remove_time_listener(ListenerId id);
     };
 
 } 
 
-#endif
\ No newline at end of file
+#endif
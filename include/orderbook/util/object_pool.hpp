@@ -0,0 +1,102 @@
+#ifndef OBJECT_POOL_HPP
+#define OBJECT_POOL_HPP
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace orderbook::util {
+
+// Fixed-size object pool carved from chunks of ChunkSize slots. Freed slots
+// go on an intrusive free list and are reused LIFO, so steady-state create /
+// destroy never reaches the global allocator. Not thread-safe: callers
+// serialize access. Objects still live when the pool dies are not destroyed.
+// Chunks come from the global heap or, when given, from a memory resource
+// such as a HugePageArena.
+template <typename T, std::size_t ChunkSize = 4096>
+class ObjectPool {
+public:
+    ObjectPool() = default;
+
+    explicit ObjectPool(std::pmr::memory_resource* resource) : resource_(resource) {}
+
+    ~ObjectPool()
+    {
+        for (Slot* chunk : chunks_) {
+            if (resource_) resource_->deallocate(chunk, sizeof(Slot) * ChunkSize, alignof(Slot));
+            else           delete[] chunk;
+        }
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    template <typename... Args>
+    T* create(Args&&... args)
+    {
+        if (!freeList_) grow();
+
+        Slot* slot = freeList_;
+        freeList_  = slot->next;
+        T* obj = ::new (static_cast<void*>(slot->storage)) T(std::forward<Args>(args)...);
+        ++live_;
+        return obj;
+    }
+
+    void destroy(T* obj)
+    {
+        if (!obj) return;
+        obj->~T();
+
+        Slot* slot = reinterpret_cast<Slot*>(obj);
+        slot->next = freeList_;
+        freeList_  = slot;
+        --live_;
+    }
+
+    // release a batch in one pass
+    void destroy_all(const std::vector<T*>& objs)
+    {
+        for (T* obj : objs) destroy(obj);
+    }
+
+    // allocate chunks up front until at least n slots exist; every slot is
+    // written, so the pages are faulted in by the calling thread
+    void reserve(std::size_t n)
+    {
+        while (capacity() < n) grow();
+    }
+
+    std::size_t size() const noexcept { return live_; }
+    std::size_t capacity() const noexcept { return chunks_.size() * ChunkSize; }
+
+private:
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    std::vector<Slot*>         chunks_;
+    Slot*                      freeList_{nullptr};
+    std::size_t                live_{0};
+    std::pmr::memory_resource* resource_{nullptr};
+
+    void grow()
+    {
+        chunks_.reserve(chunks_.size() + 1);
+        Slot* chunk = resource_ ? static_cast<Slot*>(resource_->allocate(sizeof(Slot) * ChunkSize, alignof(Slot)))
+                                : new Slot[ChunkSize];
+        for (std::size_t i = ChunkSize; i-- > 0; ) {
+            chunk[i].next = freeList_;
+            freeList_ = &chunk[i];
+        }
+        chunks_.push_back(chunk);
+    }
+};
+
+}
+
+#endif
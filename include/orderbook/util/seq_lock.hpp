@@ -0,0 +1,72 @@
+#ifndef SEQ_LOCK_HPP
+#define SEQ_LOCK_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace orderbook::util {
+
+// Single-writer sequence lock over a trivially copyable value. The writer
+// never waits; readers copy optimistically and retry if a store overlapped
+// their copy. The payload is held in relaxed atomic words so a torn read
+// is detected by the sequence check rather than being a data race.
+// Writers must be serialized by the caller.
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock payload must be trivially copyable");
+
+public:
+    SeqLock() { store(T{}); }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    void store(const T& value) noexcept
+    {
+        Words buf{};
+        std::memcpy(buf.data(), static_cast<const void*>(&value), sizeof(T));
+
+        const std::uint64_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (std::size_t i = 0; i < kWords; ++i) {
+            words_[i].store(buf[i], std::memory_order_relaxed);
+        }
+
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    T load() const noexcept
+    {
+        Words buf;
+        std::uint64_t before;
+        std::uint64_t after;
+        do {
+            before = seq_.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < kWords; ++i) {
+                buf[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = seq_.load(std::memory_order_relaxed);
+        } while ((before & 1) != 0 || before != after);
+
+        T value;
+        std::memcpy(static_cast<void*>(&value), buf.data(), sizeof(T));
+        return value;
+    }
+
+private:
+    static constexpr std::size_t kWords = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+    using Words = std::array<std::uint64_t, kWords>;
+
+    alignas(64) std::atomic<std::uint64_t> seq_{0};
+    std::array<std::atomic<std::uint64_t>, kWords> words_{};
+};
+
+}
+
+#endif
@@ -1,6 +1,10 @@
 #ifndef SIMULATED_CLOCK_HPP
 #define SIMULATED_CLOCK_HPP
 
+#include <mutex>
+#include <utility>
+#include <vector>
+
 #include "orderbook/util/i_clock.hpp"
 
 namespace orderbook::util {
@@ -18,8 +22,18 @@ void set_time(const Timestamp& t);
 
 void advance_time(const Timestamp::duration& delta);
 
+ListenerId add_time_listener(TimeListener listener) override;
+
+void remove_time_listener(ListenerId id) override;
+
 private:
     Timestamp current_;
+
+    std::mutex listenersMutex_;
+    std::vector<std::pair<ListenerId, TimeListener>> listeners_;
+    ListenerId nextListenerId_{1};
+
+    void notify_listeners();
 }; 
 
 }
@@ -0,0 +1,34 @@
+#ifndef THREAD_AFFINITY_HPP
+#define THREAD_AFFINITY_HPP
+
+namespace orderbook::util {
+
+// Pin the calling thread to one CPU; false if the platform refused or
+// does not support it. Linux and Windows only.
+bool pin_current_thread(int cpu);
+
+// NUMA node the CPU belongs to, -1 if unknown (single node or unsupported)
+int numa_node_of_cpu(int cpu);
+
+// Pins the calling thread to cpu for the lifetime of the object and then
+// restores its previous affinity. Memory first touched in between is
+// placed on that CPU's NUMA node by the kernel's first-touch policy.
+// A negative cpu does nothing.
+class ScopedAffinity {
+public:
+    explicit ScopedAffinity(int cpu);
+    ~ScopedAffinity();
+
+    ScopedAffinity(const ScopedAffinity&) = delete;
+    ScopedAffinity& operator=(const ScopedAffinity&) = delete;
+
+    bool pinned() const noexcept { return pinned_; }
+
+private:
+    bool pinned_{false};
+    alignas(8) unsigned char saved_[128];   // platform affinity mask of the thread
+};
+
+}
+
+#endif
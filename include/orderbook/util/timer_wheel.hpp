@@ -0,0 +1,70 @@
+#ifndef TIMER_WHEEL_HPP
+#define TIMER_WHEEL_HPP
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "orderbook/util/timestamp.hpp"
+
+namespace orderbook::util {
+
+// Hierarchical timer wheel (4 levels x 256 slots). Entries are never
+// removed early: owners drop stale ids when they fire, which keeps
+// schedule O(1) and advance O(expired + cascaded). An entry fires once
+// now reaches the tick containing its deadline, so owners re-check the
+// exact deadline and reschedule entries that are not due yet.
+class TimerWheel {
+public:
+    using Id       = std::uint64_t;
+    using Tick     = std::uint64_t;
+    using duration = Timestamp::duration;
+
+    TimerWheel(Timestamp start, duration resolution);
+
+    // a deadline at or before the current position fires on the next advance
+    void schedule(Id id, Timestamp deadline);
+
+    // fire every entry due at or before now, appending its id to expired
+    void advance(Timestamp now, std::vector<Id>& expired);
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    duration resolution() const { return resolution_; }
+
+private:
+    static constexpr unsigned kSlotBits = 8;
+    static constexpr unsigned kSlots    = 1u << kSlotBits;
+    static constexpr unsigned kLevels   = 4;
+    static constexpr Tick     kSlotMask = kSlots - 1;
+
+    struct Entry {
+        Id   id;
+        Tick deadline;
+    };
+
+    using Slot = std::vector<Entry>;
+
+    struct Level {
+        std::array<Slot, kSlots>                  slots;
+        std::array<std::uint64_t, kSlots / 64>    occupied{};
+    };
+
+    std::array<Level, kLevels> levels_;
+    Slot        overdue_;   // scheduled behind the current position
+    duration    resolution_;
+    Tick        current_;   // next tick to process
+    std::size_t size_{0};
+
+    Tick to_tick(Timestamp t) const;
+
+    void insert(const Entry& e);
+    void cascade(Tick t);
+    void take_slot(unsigned level, unsigned slot, Slot& out);
+    int  next_occupied(unsigned level, unsigned from) const;
+};
+
+}
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef WAIT_STRATEGY_HPP
+#define WAIT_STRATEGY_HPP
+
+#include <mutex>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace orderbook::util {
+
+// how a thread waits for a resource another thread holds
+enum class WaitStrategy {
+    Blocking,    // sleep in the kernel until woken; frees the core
+    SpinYield,   // spin briefly, then yield the time slice between attempts
+    BusySpin     // never leave the core; for isolated, pinned cores only
+};
+
+// tells the core this is a spin loop (x86 PAUSE), a no-op elsewhere
+inline void cpu_relax() noexcept
+{
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    _mm_pause();
+#endif
+}
+
+// std::mutex whose lock() follows a WaitStrategy. The spinning strategies
+// poll try_lock so an uncontended or briefly held lock is taken without a
+// syscall; unlock is always a plain mutex unlock. Satisfies Lockable.
+class WaitMutex {
+public:
+    explicit WaitMutex(WaitStrategy strategy = WaitStrategy::Blocking) noexcept : strategy_(strategy) {}
+
+    WaitMutex(const WaitMutex&) = delete;
+    WaitMutex& operator=(const WaitMutex&) = delete;
+
+    void lock()
+    {
+        switch (strategy_) {
+        case WaitStrategy::BusySpin:
+            while (!mutex_.try_lock()) cpu_relax();
+            return;
+        case WaitStrategy::SpinYield:
+            for (int i = 0; !mutex_.try_lock(); ++i) {
+                if (i < kSpinsBeforeYield) cpu_relax();
+                else                       std::this_thread::yield();
+            }
+            return;
+        case WaitStrategy::Blocking:
+        default:
+            mutex_.lock();
+            return;
+        }
+    }
+
+    bool try_lock() { return mutex_.try_lock(); }
+    void unlock() { mutex_.unlock(); }
+
+    WaitStrategy strategy() const noexcept { return strategy_; }
+
+private:
+    static constexpr int kSpinsBeforeYield = 128;
+
+    std::mutex   mutex_;
+    WaitStrategy strategy_;
+};
+
+}
+
+#endif
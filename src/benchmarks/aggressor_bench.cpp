@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "orderbook/core/matching_engine.hpp"
+#include "orderbook/util/simulated_clock.hpp"
+#include "orderbook/report/i_trade_repository.hpp"
+#include "orderbook/risk/account_risk_manager.hpp"
+
+using namespace orderbook;
+using namespace orderbook::core;
+using namespace orderbook::api;
+
+namespace {
+
+// keeps storage out of the measurement
+class NullTradeRepository : public orderbook::report::ITradeRepository {
+public:
+    void add_trades(const std::vector<Trade>&) override {}
+    std::vector<Trade> trades_between(const Symbol&, Timestamp, Timestamp) override { return {}; }
+    std::vector<Trade> trades_all(const Symbol&) override { return {}; }
+};
+
+void print_latency(const std::string& name, std::vector<std::int64_t>& ns)
+{
+    std::sort(ns.begin(), ns.end());
+    double sum = 0;
+    for (auto v : ns) sum += static_cast<double>(v);
+    std::cout << name
+              << "  mean " << sum / static_cast<double>(ns.size())
+              << "  p50 " << ns[ns.size() / 2]
+              << "  p99 " << ns[ns.size() * 99 / 100]
+              << "  (ns)\n";
+}
+
+template <typename Fn>
+std::int64_t time_ns(Fn&& fn)
+{
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+// Latency of aggressive (IOC / market) flow through MatchingEngine::new_order
+// against a book of resting depth. Resting liquidity is replenished outside
+// the timed region. Pass "risk" as the second argument to run every order
+// through the pre-trade risk stage.
+int main(int argc, char** argv)
+{
+    const int iterations = (argc > 1) ? std::atoi(argv[1]) : 200000;
+    const bool withRisk = (argc > 2) && std::string(argv[2]) == "risk";
+
+    orderbook::util::SimulatedClock clock;
+    NullTradeRepository repo;
+    MatchingEngine engine(clock, repo);
+
+    const Symbol sym = "BENCH";
+    engine.register_symbols({sym});
+
+    // every limit enabled but never hit, so the bench measures the checks
+    constexpr OwnerId kAccount = 1;
+    orderbook::risk::AccountRiskManager risk;
+    orderbook::risk::RiskLimits limits;
+    limits.maxOrderQuantity = 1000;
+    limits.maxOrderNotional = 1e6;
+    limits.maxOpenOrders    = 100000;
+    limits.maxPosition      = 1000000;
+    limits.priceCollar      = 0.10;
+    risk.set_limits(kAccount, limits);
+    if (withRisk) engine.set_risk_check(&risk);
+
+    auto order = [&](Side side, OrderType type, TimeInForce tif, Price price, Quantity qty) {
+        NewOrderRequest req(sym, side, type, tif, price, qty);
+        req.owner = kAccount;
+        return req;
+    };
+
+    // background depth on both sides
+    for (int l = 0; l < 50; ++l) {
+        for (int d = 0; d < 20; ++d) {
+            engine.new_order(order(Side::Buy,  OrderType::Limit, TimeInForce::GTC, 99.0 - 0.01 * l, 10));
+            engine.new_order(order(Side::Sell, OrderType::Limit, TimeInForce::GTC, 101.0 + 0.01 * l, 10));
+        }
+    }
+
+    std::vector<std::int64_t> noCross, oneFill, marketSweep;
+    noCross.reserve(iterations);
+    oneFill.reserve(iterations);
+    marketSweep.reserve(iterations);
+
+    const NewOrderRequest passiveIoc = order(Side::Buy, OrderType::Limit, TimeInForce::IOC, 98.0, 10);
+    const NewOrderRequest takeOne    = order(Side::Buy, OrderType::Limit, TimeInForce::IOC, 100.5, 10);
+    const NewOrderRequest sweepFive  = order(Side::Sell, OrderType::Market, TimeInForce::IOC, 0.0, 50);
+
+    for (int i = 0; i < iterations; ++i) {
+        // IOC that does not cross: pure request overhead
+        noCross.push_back(time_ns([&] { engine.new_order(passiveIoc); }));
+
+        // IOC taking exactly one resting order
+        engine.new_order(order(Side::Sell, OrderType::Limit, TimeInForce::GTC, 100.5, 10));
+        oneFill.push_back(time_ns([&] { engine.new_order(takeOne); }));
+
+        // market order taking five resting orders
+        for (int k = 0; k < 5; ++k) {
+            engine.new_order(order(Side::Buy, OrderType::Limit, TimeInForce::GTC, 99.5, 10));
+        }
+        marketSweep.push_back(time_ns([&] { engine.new_order(sweepFive); }));
+    }
+
+    std::cout << "iterations=" << iterations << (withRisk ? " risk=on" : " risk=off") << "\n";
+    print_latency("ioc no cross   ", noCross);
+    print_latency("ioc one fill   ", oneFill);
+    print_latency("market 5 fills ", marketSweep);
+    return 0;
+}
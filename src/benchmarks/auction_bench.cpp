@@ -0,0 +1,66 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "orderbook/core/order.hpp"
+#include "orderbook/core/order_book.hpp"
+
+using namespace orderbook;
+using namespace orderbook::core;
+
+namespace {
+
+double ms_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+// Call auction cost: `orders` limit orders priced uniformly over +-`ticks`
+// cent ticks around 100.00 are collected without matching, then the book
+// is uncrossed once. Reports the equilibrium search and the bulk execution.
+int main(int argc, char** argv)
+{
+    const int orders = (argc > 1) ? std::atoi(argv[1]) : 200000;
+    const int ticks  = (argc > 2) ? std::atoi(argv[2]) : 500;
+
+    std::vector<Order> arena(static_cast<std::size_t>(orders));
+    std::mt19937_64 rng{42};
+    std::uniform_int_distribution<int> tick(-ticks, ticks);
+    std::uniform_int_distribution<int> size(1, 100);
+
+    OrderBook book;
+    FillBuffer fills;
+    book.start_auction();
+
+    for (int i = 0; i < orders; ++i) {
+        const Side side = (i % 2 == 0) ? Side::Buy : Side::Sell;
+        const Price price = static_cast<double>(10000 + tick(rng)) / 100.0;
+        Order& o = arena[static_cast<std::size_t>(i)];
+        o = Order(static_cast<OrderId>(i + 1), "BENCH", side, OrderType::Limit, TimeInForce::GTC,
+                  price, size(rng), Timestamp{Timestamp::time_point{}});
+        book.submit_order(o, fills);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    const AuctionResult indicative = book.indicative_uncross();
+    const double searchMs = ms_since(start);
+
+    start = std::chrono::steady_clock::now();
+    const AuctionResult result = book.uncross(fills);
+    const double uncrossMs = ms_since(start);
+
+    std::vector<Order*> completed;
+    book.collect_filled_orders(completed);
+
+    std::cout << "orders=" << orders << " levels per side~" << (2 * ticks + 1) << "\n"
+              << "price:          " << result.price << " (indicative " << indicative.price << ")\n"
+              << "volume:         " << result.volume << "  surplus " << result.surplus << "\n"
+              << "fills:          " << fills.size() << "  orders filled " << completed.size() << "\n"
+              << "search ms:      " << searchMs << "\n"
+              << "uncross ms:     " << uncrossMs << "\n";
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "orderbook/core/order.hpp"
+#include "orderbook/core/order_book.hpp"
+#include "orderbook/util/huge_page_arena.hpp"
+
+using namespace orderbook;
+using namespace orderbook::core;
+
+// counts every global allocation so the sweep can be checked allocation-free
+static std::size_t g_allocations = 0;
+
+void* operator new(std::size_t size)
+{
+    ++g_allocations;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// Sweep throughput: rest `levels` x `depth` asks, then clear them with a
+// single aggressive buy, repeatedly. Resting orders are drawn from a
+// shuffled arena so consecutive queue entries live at unrelated addresses,
+// like orders allocated over a trading day. The fourth argument picks the
+// memory the book's containers use: heap (default resource, no pooling),
+// pool (pooled on the heap), monotonic (pooled on a monotonic buffer) or
+// arena (pooled on a huge-page arena).
+int main(int argc, char** argv)
+{
+    const int levels = (argc > 1) ? std::atoi(argv[1]) : 50;
+    const int depth  = (argc > 2) ? std::atoi(argv[2]) : 20;
+    const int rounds = (argc > 3) ? std::atoi(argv[3]) : 2000;
+    const std::string memory = (argc > 4) ? argv[4] : "heap";
+
+    std::unique_ptr<std::pmr::memory_resource> upstream;
+    if (memory == "monotonic") {
+        upstream = std::make_unique<std::pmr::monotonic_buffer_resource>(std::size_t{64} << 20);
+    }
+    else if (memory == "arena") {
+        upstream = std::make_unique<orderbook::util::HugePageArena>(std::size_t{64} << 20);
+    }
+    else if (memory != "heap" && memory != "pool") {
+        std::cerr << "memory must be heap, pool, monotonic or arena\n";
+        return 1;
+    }
+    std::pmr::memory_resource* bookMemory = memory == "pool" ? std::pmr::new_delete_resource() : upstream.get();
+
+    const std::size_t perRound = static_cast<std::size_t>(levels) * static_cast<std::size_t>(depth);
+    const std::size_t arenaSize = perRound * 64;
+
+    std::vector<Order> arena(arenaSize);
+    std::vector<std::size_t> slots(arenaSize);
+    std::iota(slots.begin(), slots.end(), std::size_t{0});
+    std::shuffle(slots.begin(), slots.end(), std::mt19937_64{42});
+
+    OrderBook book(bookMemory);
+    FillBuffer fillBuffer(perRound);
+    std::vector<Order*> completed;
+    OrderId nextId = 1;
+    std::size_t cursor = 0;
+    std::size_t fills = 0;
+    std::size_t sweepAllocations = 0;
+    std::chrono::nanoseconds elapsed{0};
+
+    for (int r = 0; r < rounds; ++r) {
+        for (int l = 0; l < levels; ++l) {
+            for (int d = 0; d < depth; ++d) {
+                Order& o = arena[slots[cursor]];
+                cursor = (cursor + 1) % arenaSize;
+                o = Order(nextId++, "BENCH", Side::Sell, OrderType::Limit, TimeInForce::GTC,
+                          100.0 + 0.01 * l, 10, Timestamp{Timestamp::time_point{}});
+                book.submit_order(o, fillBuffer);
+            }
+        }
+
+        Order aggressor(nextId++, "BENCH", Side::Buy, OrderType::Limit, TimeInForce::IOC,
+                        100.0 + 0.01 * levels, static_cast<Quantity>(perRound) * 10,
+                        Timestamp{Timestamp::time_point{}});
+
+        fillBuffer.clear();
+        const std::size_t allocsBefore = g_allocations;
+        const auto start = std::chrono::steady_clock::now();
+        book.submit_order(aggressor, fillBuffer);
+        elapsed += std::chrono::steady_clock::now() - start;
+        sweepAllocations += g_allocations - allocsBefore;
+
+        fills += fillBuffer.size();
+
+        // the arena owns the orders; just drain the completion list
+        completed.clear();
+        book.collect_filled_orders(completed);
+    }
+
+    const double secs = std::chrono::duration<double>(elapsed).count();
+    std::cout << "levels=" << levels << " depth=" << depth << " rounds=" << rounds << " memory=" << memory << "\n"
+              << "fills:          " << fills << "\n"
+              << "ns per fill:    " << (secs * 1e9 / static_cast<double>(fills)) << "\n"
+              << "fills per sec:  " << (static_cast<double>(fills) / secs) << "\n"
+              << "sweeps per sec: " << (static_cast<double>(rounds) / secs) << "\n"
+              << "allocs / sweep: " << (static_cast<double>(sweepAllocations) / rounds) << "\n";
+    return 0;
+}
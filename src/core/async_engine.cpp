@@ -0,0 +1,175 @@
+#include "orderbook/core/async_engine.hpp"
+#include "orderbook/util/thread_affinity.hpp"
+
+#include <functional>
+
+namespace orderbook::core {
+
+namespace {
+
+// Trades are published synchronously on the thread that made them, so a
+// worker learns what its request traded by listening while it executes it.
+// Each AsyncEngine's listener has its own id; it collects only while the
+// running command belongs to it.
+struct TradeCollector {
+    std::uint64_t       listener{0};
+    std::vector<Trade>* out{nullptr};
+};
+
+thread_local TradeCollector tCollector;
+std::atomic<std::uint64_t>  gNextListener{1};
+
+class ScopedCollect {
+public:
+    ScopedCollect(std::uint64_t listener, std::vector<Trade>& out) : saved_(tCollector)
+    {
+        tCollector = TradeCollector{listener, &out};
+    }
+    ~ScopedCollect() { tCollector = saved_; }
+
+    ScopedCollect(const ScopedCollect&) = delete;
+    ScopedCollect& operator=(const ScopedCollect&) = delete;
+
+private:
+    TradeCollector saved_;
+};
+
+}
+
+AsyncEngine::AsyncEngine(MatchingEngine& engine, const Options& options)
+    : engine_(engine)
+    , wait_(options.wait)
+    , listener_(gNextListener.fetch_add(1, std::memory_order_relaxed))
+{
+    tradeListenerId_ = engine_.register_trade_listener([listener = listener_](const std::vector<Trade>& trades) {
+        if (tCollector.listener != listener || !tCollector.out) return;
+        tCollector.out->insert(tCollector.out->end(), trades.begin(), trades.end());
+    });
+
+    const std::size_t n = options.shards == 0 ? 1 : options.shards;
+    shards_.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) shards_.push_back(std::make_unique<Shard>());
+    for (std::size_t i = 0; i < n; ++i) {
+        const int cpu = options.cpus.empty() ? -1 : options.cpus[i % options.cpus.size()];
+        shards_[i]->worker = std::thread([this, &shard = *shards_[i], cpu] { run_worker(shard, cpu); });
+    }
+}
+
+AsyncEngine::~AsyncEngine()
+{
+    stop_.store(true, std::memory_order_release);
+    for (auto& shard : shards_) {
+        { std::lock_guard<std::mutex> lock(shard->mutex); }
+        shard->ready.notify_one();
+    }
+    for (auto& shard : shards_) shard->worker.join();
+    engine_.remove_trade_listener(tradeListenerId_);
+}
+
+std::size_t AsyncEngine::shard_of(const Symbol& symbol) const noexcept
+{
+    return std::hash<Symbol>{}(symbol) % shards_.size();
+}
+
+void AsyncEngine::enqueue(std::size_t index, Command* command)
+{
+    inFlight_.fetch_add(1, std::memory_order_relaxed);
+
+    Shard& shard = *shards_[index];
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.commands.push_back(command);
+        shard.pending.store(true, std::memory_order_release);
+    }
+    if (wait_ == WaitStrategy::Blocking) shard.ready.notify_one();
+}
+
+void AsyncEngine::run_worker(Shard& shard, int cpu)
+{
+    if (cpu >= 0) orderbook::util::pin_current_thread(cpu);
+
+    std::vector<Command*> batch;
+    while (true) {
+        if (wait_ == WaitStrategy::Blocking) {
+            std::unique_lock<std::mutex> lock(shard.mutex);
+            shard.ready.wait(lock, [&] { return !shard.commands.empty() || stop_.load(std::memory_order_acquire); });
+            batch.swap(shard.commands);
+            shard.pending.store(false, std::memory_order_relaxed);
+        }
+        else {
+            for (int i = 0; !shard.pending.load(std::memory_order_acquire) && !stop_.load(std::memory_order_acquire); ++i) {
+                if (wait_ == WaitStrategy::BusySpin || i < 128) orderbook::util::cpu_relax();
+                else                                             std::this_thread::yield();
+            }
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            batch.swap(shard.commands);
+            shard.pending.store(false, std::memory_order_relaxed);
+        }
+
+        // commands queued before stop still run, so no awaiter is lost
+        if (batch.empty()) {
+            if (stop_.load(std::memory_order_acquire)) return;
+            continue;
+        }
+
+        for (Command* command : batch) command->execute(engine_);
+        complete(batch);
+        batch.clear();
+    }
+}
+
+void AsyncEngine::complete(const std::vector<Command*>& batch)
+{
+    {
+        std::lock_guard<std::mutex> lock(completedMutex_);
+        for (Command* command : batch) completed_.push_back(command->handle_);
+    }
+    completedReady_.notify_one();
+}
+
+std::size_t AsyncEngine::poll()
+{
+    // take the batch out first: a resumed coroutine may issue requests
+    // that complete into completed_ while we are still resuming
+    {
+        std::lock_guard<std::mutex> lock(completedMutex_);
+        resuming_.swap(completed_);
+    }
+
+    const std::size_t n = resuming_.size();
+    inFlight_.fetch_sub(n, std::memory_order_relaxed);
+    for (auto h : resuming_) h.resume();
+    resuming_.clear();
+    return n;
+}
+
+std::size_t AsyncEngine::wait()
+{
+    {
+        std::unique_lock<std::mutex> lock(completedMutex_);
+        completedReady_.wait(lock, [this] {
+            return !completed_.empty() || inFlight_.load(std::memory_order_relaxed) == 0;
+        });
+    }
+    return poll();
+}
+
+void AsyncEngine::SubmitAwaitable::execute(MatchingEngine& engine)
+{
+    ScopedCollect collect(async_.listener_, result_.trades);
+    result_.order.symbol  = req_.symbol;
+    result_.order.orderId = engine.new_order(req_, result_.reason);
+}
+
+void AsyncEngine::CancelAwaitable::execute(MatchingEngine& engine)
+{
+    result_ = engine.cancel_order(orderId_);
+}
+
+void AsyncEngine::ModifyAwaitable::execute(MatchingEngine& engine)
+{
+    ScopedCollect collect(async_.listener_, result_.trades);
+    result_.accepted = engine.modify_order(orderId_, req_);
+}
+
+}
@@ -0,0 +1,63 @@
+#include "orderbook/core/auction.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace orderbook::core {
+
+AuctionResult compute_uncross(const std::vector<AuctionLevel>& bids,
+                              const std::vector<AuctionLevel>& asks,
+                              Price reference)
+{
+    Quantity bidTotal = 0;
+    for (const auto& l : bids) bidTotal += l.quantity;
+
+    AuctionResult best;
+    Quantity bestAbsSurplus = 0;
+
+    // prices tied on rules 1 and 2, seen in ascending order
+    AuctionResult tieLow, tieHigh, tieClosest;
+    bool allBuySurplus  = false;
+    bool allSellSurplus = false;
+
+    Quantity bidBelow = 0;    // bids priced below the candidate
+    Quantity askUpTo  = 0;    // asks priced at or below the candidate
+    std::size_t i = 0, j = 0;
+
+    while (i < bids.size() || j < asks.size()) {
+        const bool bidNext = j == asks.size() || (i < bids.size() && bids[i].price < asks[j].price);
+        const Price p = bidNext ? bids[i].price : asks[j].price;
+
+        while (j < asks.size() && asks[j].price == p) askUpTo += asks[j++].quantity;
+        const Quantity buyVol = bidTotal - bidBelow;
+        while (i < bids.size() && bids[i].price == p) bidBelow += bids[i++].quantity;
+
+        const Quantity volume = std::min(buyVol, askUpTo);
+        if (volume == 0) continue;
+
+        const AuctionResult cand{p, volume, buyVol - askUpTo};
+        const Quantity absSurplus = std::abs(cand.surplus);
+
+        if (volume > best.volume || (volume == best.volume && absSurplus < bestAbsSurplus)) {
+            best           = cand;
+            bestAbsSurplus = absSurplus;
+            tieLow = tieHigh = tieClosest = cand;
+            allBuySurplus  = cand.surplus > 0;
+            allSellSurplus = cand.surplus < 0;
+        }
+        else if (volume == best.volume && absSurplus == bestAbsSurplus) {
+            tieHigh = cand;
+            allBuySurplus  = allBuySurplus && cand.surplus > 0;
+            allSellSurplus = allSellSurplus && cand.surplus < 0;
+            if (std::fabs(p - reference) < std::fabs(tieClosest.price - reference)) tieClosest = cand;
+        }
+    }
+
+    if (best.volume == 0) return AuctionResult{};
+    if (allBuySurplus)  return tieHigh;
+    if (allSellSurplus) return tieLow;
+    return tieClosest;
+}
+
+}
@@ -0,0 +1,185 @@
+#include "orderbook/core/dark_book.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace orderbook::core {
+
+namespace {
+
+// smallest execution the order accepts
+Quantity min_fill(const Order& o)
+{
+    return std::min(o.minQty, o.remaining);
+}
+
+template <typename DarkMap>
+bool remove_from(DarkMap& orders, const Order& order)
+{
+    auto it = orders.find(order.price);
+    if (it == orders.end()) return false;
+
+    auto& queue = it->second;
+    for (auto qit = queue.begin(); qit != queue.end(); ++qit) {
+        if ((*qit)->orderId == order.orderId) {
+            queue.erase(qit);
+            if (queue.empty()) orders.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename DarkMap>
+std::size_t remove_from_if(DarkMap& orders, const OrderPredicate& pred, std::vector<Order*>& removed)
+{
+    std::size_t count = 0;
+    for (auto it = orders.begin(); it != orders.end(); ) {
+        auto& queue = it->second;
+        auto keep = queue.begin();
+        for (auto qit = queue.begin(); qit != queue.end(); ++qit) {
+            if (pred(**qit)) {
+                removed.push_back(*qit);
+                ++count;
+            }
+            else {
+                *keep++ = *qit;
+            }
+        }
+        queue.erase(keep, queue.end());
+
+        if (queue.empty()) {
+            it = orders.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    return count;
+}
+
+// walk the eligible limits in priority order; an order whose minimum the
+// execution would not meet is passed over, not blocking those behind it
+template <typename DarkMap, typename Eligible>
+void match_side(DarkMap& orders, std::size_t& count, Eligible eligible, Order& incoming, Price mid,
+                FillBuffer& fills, std::vector<Order*>& completed, std::vector<Order*>& cancelled)
+{
+    const bool preventSelfTrade = incoming.stp != SelfTradePrevention::None && incoming.owner != INVALID_OWNER_ID;
+
+    for (auto it = orders.begin(); it != orders.end() && incoming.remaining > 0 && eligible(it->first); ) {
+        auto& queue = it->second;
+        for (auto qit = queue.begin(); qit != queue.end() && incoming.remaining > 0; ) {
+            Order& resting = **qit;
+
+            if (preventSelfTrade && resting.owner == incoming.owner) {
+                const SelfTradePrevention mode = incoming.stp;
+                if (mode == SelfTradePrevention::CancelIncoming) {
+                    incoming.reduce(incoming.remaining);
+                    break;
+                }
+                if (mode == SelfTradePrevention::Decrement) {
+                    const Quantity decQty = std::min(incoming.remaining, resting.remaining);
+                    incoming.reduce(decQty);
+                    resting.reduce(decQty);
+                }
+                else {
+                    if (mode == SelfTradePrevention::CancelBoth) incoming.reduce(incoming.remaining);
+                    resting.reduce(resting.remaining);
+                }
+                if (resting.remaining == 0) {
+                    cancelled.push_back(&resting);
+                    qit = queue.erase(qit);
+                    --count;
+                }
+                else {
+                    ++qit;
+                }
+                continue;
+            }
+
+            const Quantity matchQty = std::min(incoming.remaining, resting.remaining);
+            if (matchQty < min_fill(resting) || matchQty < min_fill(incoming)) {
+                ++qit;
+                continue;
+            }
+
+            incoming.add_fill(matchQty);
+            resting.add_fill(matchQty);
+            if (incoming.side == Side::Buy) {
+                fills.push(Fill{incoming.orderId, resting.orderId, mid, matchQty});
+            }
+            else {
+                fills.push(Fill{resting.orderId, incoming.orderId, mid, matchQty});
+            }
+
+            if (resting.remaining == 0) {
+                completed.push_back(&resting);
+                qit = queue.erase(qit);
+                --count;
+            }
+            else {
+                ++qit;
+            }
+        }
+
+        if (queue.empty()) {
+            it = orders.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+}
+
+void DarkBook::add_order(Order* order)
+{
+    if (!order) return;
+    assert(order->isDark && "[dark book] add_order called with a lit order");
+
+    if (order->side == Side::Buy) {
+        buys_[order->price].push_back(order);
+        ++buyCount_;
+    }
+    else {
+        sells_[order->price].push_back(order);
+        ++sellCount_;
+    }
+}
+
+bool DarkBook::remove_order(const Order& order)
+{
+    if (order.side == Side::Buy) {
+        if (!remove_from(buys_, order)) return false;
+        --buyCount_;
+    }
+    else {
+        if (!remove_from(sells_, order)) return false;
+        --sellCount_;
+    }
+    return true;
+}
+
+std::size_t DarkBook::remove_orders_if(const OrderPredicate& pred, std::vector<Order*>& removed)
+{
+    const std::size_t buys  = remove_from_if(buys_, pred, removed);
+    const std::size_t sells = remove_from_if(sells_, pred, removed);
+    buyCount_  -= buys;
+    sellCount_ -= sells;
+    return buys + sells;
+}
+
+void DarkBook::match(Order& incoming, Price mid, FillBuffer& fills,
+                     std::vector<Order*>& completed, std::vector<Order*>& cancelled)
+{
+    if (incoming.side == Side::Buy) {
+        match_side(sells_, sellCount_, [mid](Price limit) { return limit <= mid; },
+                   incoming, mid, fills, completed, cancelled);
+    }
+    else {
+        match_side(buys_, buyCount_, [mid](Price limit) { return limit >= mid; },
+                   incoming, mid, fills, completed, cancelled);
+    }
+}
+
+}
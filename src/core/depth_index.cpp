@@ -0,0 +1,76 @@
+#include "orderbook/core/depth_index.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+
+namespace orderbook::core {
+
+bool DepthIndex::covers(Price price) const
+{
+    if (tree_.empty()) return false;
+    const Bucket b = bucket_of(price);
+    return b >= base_ && b < base_ + static_cast<Bucket>(tree_.size() - 1);
+}
+
+void DepthIndex::reset(Price minPrice, Price maxPrice)
+{
+    assert(minPrice <= maxPrice && "[depth index] reset with inverted range");
+
+    auto span = [&]() { return static_cast<std::size_t>(bucket_of(maxPrice) - bucket_of(minPrice) + 1); };
+    while (span() * 2 > kMaxBuckets) width_ *= 2.0;
+
+    const std::size_t capacity = std::clamp(std::bit_ceil(span() * 2), kMinBuckets, kMaxBuckets);
+    base_  = bucket_of(minPrice) - static_cast<Bucket>((capacity - span()) / 2);
+    total_ = 0;
+    tree_.assign(capacity + 1, 0);
+}
+
+void DepthIndex::add(Price price, Quantity delta)
+{
+    assert(covers(price) && "[depth index] add outside the covered range");
+
+    total_ += delta;
+    const std::size_t n = tree_.size() - 1;
+    for (std::size_t i = static_cast<std::size_t>(bucket_of(price) - base_) + 1; i <= n; i += i & (~i + 1)) {
+        tree_[i] += delta;
+    }
+}
+
+DepthIndex::Bucket DepthIndex::bucket_of(Price price) const
+{
+    return static_cast<Bucket>(std::floor(price / width_));
+}
+
+Quantity DepthIndex::sum_before(Bucket b) const
+{
+    if (tree_.empty() || b <= base_) return 0;
+
+    const std::size_t n = tree_.size() - 1;
+    std::size_t i = static_cast<std::size_t>(b - base_);
+    if (i >= n) return total_;
+
+    Quantity sum = 0;
+    for (; i > 0; i -= i & (~i + 1)) sum += tree_[i];
+    return sum;
+}
+
+DepthIndex::Bucket DepthIndex::first_exceeding(Quantity threshold, Quantity& before) const
+{
+    assert(threshold < total_ && "[depth index] first_exceeding past the total quantity");
+
+    const std::size_t n = tree_.size() - 1;
+    std::size_t pos = 0;
+    Quantity acc = 0;
+    for (std::size_t step = std::bit_floor(n); step > 0; step >>= 1) {
+        if (pos + step <= n && acc + tree_[pos + step] <= threshold) {
+            pos += step;
+            acc += tree_[pos];
+        }
+    }
+    before = acc;
+    return base_ + static_cast<Bucket>(pos);
+}
+
+}
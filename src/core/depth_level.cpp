@@ -0,0 +1,27 @@
+#include "orderbook/core/depth_level.hpp"
+
+namespace orderbook::core {
+
+void accumulate_depth(DepthLevel* levels, std::size_t count)
+{
+    for (std::size_t i = 1; i < count; ++i) {
+        levels[i].quantity   += levels[i - 1].quantity;
+        levels[i].orderCount += levels[i - 1].orderCount;
+    }
+}
+
+Quantity depth_quantity(const DepthLevel* levels, std::size_t count)
+{
+    Quantity total = 0;
+    for (std::size_t i = 0; i < count; ++i) total += levels[i].quantity;
+    return total;
+}
+
+double depth_imbalance(Quantity bidQuantity, Quantity askQuantity)
+{
+    const Quantity total = bidQuantity + askQuantity;
+    if (total <= 0) return 0.0;
+    return static_cast<double>(bidQuantity - askQuantity) / static_cast<double>(total);
+}
+
+}
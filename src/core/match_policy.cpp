@@ -0,0 +1,51 @@
+#include "orderbook/core/match_policy.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace orderbook::core {
+
+void ProRataMatch::allocate(const PriceLevel::OrdersQueue& queue, Quantity qty, Quantity levelVolume,
+                            AllocationScratch& scratch)
+{
+    auto& alloc = scratch.alloc;
+    alloc.assign(queue.size(), 0);
+
+    // floor(qty * visible / levelVolume), clamped so rounding in the
+    // division can never hand out more than qty
+    const double ratio = static_cast<double>(qty) / static_cast<double>(levelVolume);
+    Quantity given = 0;
+    for (std::size_t i = 0; i < queue.size(); ++i) {
+        const Quantity visible = queue[i].visible;
+        const auto share = static_cast<Quantity>(static_cast<double>(visible) * ratio);
+        alloc[i] = std::min({share, visible, qty - given});
+        given += alloc[i];
+    }
+
+    for (std::size_t i = 0; i < queue.size() && given < qty; ++i) {
+        const Quantity extra = std::min(qty - given, queue[i].visible - alloc[i]);
+        alloc[i] += extra;
+        given    += extra;
+    }
+}
+
+void SizeTimeMatch::allocate(const PriceLevel::OrdersQueue& queue, Quantity qty, Quantity /*levelVolume*/,
+                             AllocationScratch& scratch)
+{
+    auto& alloc = scratch.alloc;
+    auto& rank  = scratch.rank;
+    alloc.assign(queue.size(), 0);
+    rank.resize(queue.size());
+    std::iota(rank.begin(), rank.end(), std::size_t{0});
+    std::stable_sort(rank.begin(), rank.end(), [&queue](std::size_t a, std::size_t b) {
+        return queue[a].visible > queue[b].visible;
+    });
+
+    for (std::size_t i = 0; i < rank.size() && qty > 0; ++i) {
+        const Quantity take = std::min(qty, queue[rank[i]].visible);
+        alloc[rank[i]] = take;
+        qty -= take;
+    }
+}
+
+}
@@ -1,174 +1,387 @@
 #include "orderbook/core/matching_engine.hpp"
-#include <unordered_set>
+#include "orderbook/util/thread_affinity.hpp"
+#include <algorithm>
 #include <cassert>
 
 namespace orderbook::core {
 
+struct MatchingEngine::MatchScratch {
+    FillBuffer          fills;
+    std::vector<Trade>  trades;
+    std::vector<Order*> triggered;
+    std::vector<Order*> finished;
+};
+
+// Hands out this thread's scratch buffers, cleared. One set per nesting
+// level: a trade listener may submit orders from its callback and must not
+// overwrite the trades it is being handed.
+class MatchingEngine::ScratchLease {
+public:
+    ScratchLease()
+    {
+        if (depth_ == pool_.size()) pool_.push_back(std::make_unique<MatchScratch>());
+        scratch_ = pool_[depth_++].get();
+        scratch_->fills.clear();
+        scratch_->trades.clear();
+        scratch_->triggered.clear();
+        scratch_->finished.clear();
+    }
+
+    ~ScratchLease() { --depth_; }
+
+    ScratchLease(const ScratchLease&) = delete;
+    ScratchLease& operator=(const ScratchLease&) = delete;
+
+    MatchScratch& get() noexcept { return *scratch_; }
+
+private:
+    static thread_local std::vector<std::unique_ptr<MatchScratch>> pool_;
+    static thread_local std::size_t depth_;
+
+    MatchScratch* scratch_;
+};
+
+thread_local std::vector<std::unique_ptr<MatchingEngine::MatchScratch>> MatchingEngine::ScratchLease::pool_;
+thread_local std::size_t MatchingEngine::ScratchLease::depth_ = 0;
+
+namespace {
+
+// mapped and pre-faulted on the home CPU so its pages sit on that node
+std::unique_ptr<HugePageArena> make_arena(const EngineConfig& config)
+{
+    if (config.hugePageArenaBytes == 0 || config.memory) return nullptr;
+    orderbook::util::ScopedAffinity home(config.homeCpu);
+    return std::make_unique<HugePageArena>(config.hugePageArenaBytes, config.hugePageSize);
+}
+
+}
+
 MatchingEngine::MatchingEngine(IClock& clock,
                                ITradeRepository& tradeRepo)
-    : books_()
+    : MatchingEngine(clock, tradeRepo, EngineConfig{})
+{
+}
+
+MatchingEngine::MatchingEngine(IClock& clock,
+                               ITradeRepository& tradeRepo,
+                               const EngineConfig& config)
+    : arena_(make_arena(config))
+    , memory_(config.memory ? config.memory : arena_.get())
+    , registryPool_(memory_ ? std::make_unique<std::pmr::unsynchronized_pool_resource>(memory_) : nullptr)
+    , books_(std::max(kExpectedSymbols, config.symbols.size()), config.lockWait,
+             [bookMemory = config.bookMemory, memory = memory_](const Symbol& symbol) {
+                 std::pmr::memory_resource* own = bookMemory ? bookMemory(symbol) : nullptr;
+                 return own ? own : memory;
+             })
+    , ordersRegistry_(registryPool_ ? registryPool_.get() : std::pmr::get_default_resource())
+    , orderPool_(memory_)
     , clock_(clock)
     , tradeRepo_(tradeRepo)
     , orderIdGenerator_()
     , tradeIdGenerator_()
+    , expiryWheel_(clock.now(), kExpiryResolution)
+    , registryMutex_(config.lockWait)
 {
+    {
+        // books and order slots are first written here, on the home CPU
+        orderbook::util::ScopedAffinity home(config.homeCpu);
+        orderPool_.reserve(config.orderPoolCapacity);
+        ordersRegistry_.reserve(config.orderPoolCapacity);
+        if (!config.symbols.empty()) books_.reserve_symbols(config.symbols);
+    }
+
+    clockListenerId_ = clock_.add_time_listener([this](const Timestamp&) { expire_orders(); });
+}
+
+MatchingEngine::~MatchingEngine()
+{
+    clock_.remove_time_listener(clockListenerId_);
+
+    for (auto& kv : ordersRegistry_) orderPool_.destroy(kv.second);
 }
 
 orderbook::RejectReason MatchingEngine::validate_new_order(const NewOrderRequest& req) const
 {
     if (req.quantity <= 0) return orderbook::RejectReason::InvalidQuantity;
-    if (req.type == orderbook::OrderType::Limit) {
+    if (req.displayQuantity < 0) return orderbook::RejectReason::InvalidQuantity;
+    if (req.displayQuantity > 0 && req.type != orderbook::OrderType::Limit) {
+        return orderbook::RejectReason::UnsupportedOrderType;
+    }
+    if (req.minQuantity < 0 || req.minQuantity > req.quantity) return orderbook::RejectReason::InvalidQuantity;
+    if (req.minQuantity > 0 && !req.isDark) return orderbook::RejectReason::UnsupportedOrderType;
+    if (req.isDark) {
+        // a plain limit that never shows; FOK is not offered against hidden size
+        if (req.type != orderbook::OrderType::Limit || req.isStop || req.displayQuantity > 0
+            || req.pegType != orderbook::PegType::None || req.tif == orderbook::TimeInForce::FOK) {
+            return orderbook::RejectReason::UnsupportedOrderType;
+        }
+    }
+    if (req.pegType != orderbook::PegType::None) {
+        // a resting limit whose price follows the touch
+        if (req.type != orderbook::OrderType::Limit || req.isStop || req.displayQuantity > 0 || !rests_on_book(req.tif)) {
+            return orderbook::RejectReason::UnsupportedOrderType;
+        }
+        // the offset must keep the peg off the opposite touch: only pegs can cross pegs
+        const Price towardCross = (req.side == orderbook::Side::Buy) ? req.pegOffset : -req.pegOffset;
+        const bool  crosses     = (req.pegType == orderbook::PegType::Market) ? towardCross >= 0.0 : towardCross > 0.0;
+        if (crosses) return orderbook::RejectReason::InvalidPegOffset;
+    }
+    else if (req.type == orderbook::OrderType::Limit) {
         if (req.price <= 0.0) return orderbook::RejectReason::InvalidPrice;
     }
     if (req.type != orderbook::OrderType::Limit && req.type != orderbook::OrderType::Market) {
         return orderbook::RejectReason::UnsupportedOrderType;
     }
+    if (req.tif == orderbook::TimeInForce::GTD && req.expireTime <= clock_.now()) {
+        return orderbook::RejectReason::InvalidExpireTime;
+    }
+    if (req.tif == orderbook::TimeInForce::DAY) {
+        const auto endNs = sessionEndNs_.load(std::memory_order_relaxed);
+        if (endNs == 0 || endNs <= clock_.now().value().time_since_epoch().count()) {
+            return orderbook::RejectReason::InvalidExpireTime;
+        }
+    }
+    if (req.isStop) {
+        if (req.stopPrice <= 0.0) return orderbook::RejectReason::InvalidPrice;
+        const auto expected = (req.stopType == orderbook::StopType::StopMarket) ? orderbook::OrderType::Market
+                                                                                : orderbook::OrderType::Limit;
+        if (req.type != expected) return orderbook::RejectReason::UnsupportedOrderType;
+    }
     return orderbook::RejectReason::None;
 }
 
 orderbook::RejectReason MatchingEngine::validate_modify_order(const Order& order, const ModifyOrderRequest& req) const
 {
-    if (order.tif != TimeInForce::GTC) return orderbook::RejectReason::UnsupportedTimeInForce;
+    if (!rests_on_book(order.tif)) return orderbook::RejectReason::UnsupportedTimeInForce;
+    if (order.isStop) return orderbook::RejectReason::UnsupportedOrderType;
     if (req.hasNewQuantity && req.newQuantity < order.filled) return orderbook::RejectReason::InvalidQuantity;
-    if (req.hasNewPrice && order.type == orderbook::OrderType::Market) return orderbook::RejectReason::UnsupportedOrderType;
+    if (req.hasNewPrice && (order.type == orderbook::OrderType::Market || order.is_pegged())) {
+        return orderbook::RejectReason::UnsupportedOrderType;
+    }
     if (req.hasNewPrice && req.newPrice <= 0.0) return orderbook::RejectReason::InvalidPrice;
     return orderbook::RejectReason::None;
 }
 
 OrderId MatchingEngine::new_order(const NewOrderRequest& req)
 {
-    auto vr = validate_new_order(req);
-    if (vr != orderbook::RejectReason::None) return INVALID_ORDER_ID;
+    orderbook::RejectReason reason;
+    return new_order(req, reason);
+}
 
-    std::unique_lock<std::mutex> symLock(*get_or_create_symbol_mutex(req.symbol));
+OrderId MatchingEngine::new_order(const NewOrderRequest& req, orderbook::RejectReason& reason)
+{
+    poll_expiries();
 
-    auto ptr = std::make_unique<Order>();
-    Order& o = *ptr;
-    o.orderId   = orderIdGenerator_.next();
-    o.symbol    = req.symbol;
-    o.side      = req.side;
-    o.type      = req.type;
-    o.tif       = req.tif;
-    o.price     = req.price;
-    o.qty       = req.quantity;
-    o.remaining = req.quantity;
-    o.filled    = 0;
-    o.timestamp = clock_.now();
-    if (o.type == OrderType::Market && o.tif == TimeInForce::GTC) {
-        o.tif = TimeInForce::IOC;
+    reason = validate_new_order(req);
+    if (reason != orderbook::RejectReason::None) return INVALID_ORDER_ID;
+
+    BookEntry& entry = books_.get_or_create(req.symbol);
+    if (req.isDark && !entry.book.has_dark_book()) {
+        reason = orderbook::RejectReason::DarkBookDisabled;
+        return INVALID_ORDER_ID;
     }
-    const OrderId id = o.orderId;
 
-    {
-        std::lock_guard<std::mutex> regLock(registryMutex_);
-        ordersRegistry_.emplace(id, std::move(ptr));
+    // a state change racing past these checks is caught by submit_order,
+    // which cancels the order
+    const bool immediate = !req.isStop && (req.type == OrderType::Market || !rests_on_book(req.tif));
+    const TradingState state = entry.book.trading_state();
+    if (state == TradingState::Halted) {
+        reason = orderbook::RejectReason::SymbolHalted;
+        return INVALID_ORDER_ID;
+    }
+    if (state == TradingState::Auction && (immediate || req.pegType != orderbook::PegType::None)) {
+        reason = orderbook::RejectReason::NotAllowedInAuction;
+        return INVALID_ORDER_ID;
     }
 
-    OrderBook& book = get_or_create_book(o.symbol);
-    std::vector<Trade> trades = book.submit_order(o);
+    // outside the symbol lock: the risk stage only reads the book's snapshot
+    if (riskCheck_) {
+        reason = riskCheck_->check_new_order(req, entry.book);
+        if (reason != orderbook::RejectReason::None) return INVALID_ORDER_ID;
+    }
 
-    if (o.tif != TimeInForce::GTC && o.remaining > 0) {
-        std::lock_guard<std::mutex> regLock(registryMutex_);
-        ordersRegistry_.erase(id);
+    // IOC / FOK / market orders never rest: match them straight from the
+    // stack, bypassing the pool and the registry
+    if (immediate) {
+        return new_immediate_order(req, entry);
     }
 
-    if (!trades.empty()) {
-        clean_registry(trades);
+    std::unique_lock<WaitMutex> symLock(entry.mutex);
+
+    Order* optr = nullptr;
+    {
+        std::lock_guard<WaitMutex> regLock(registryMutex_);
+        optr = orderPool_.create();
     }
+    Order& o = *optr;
+    init_order(o, req);
+    const OrderId id = o.orderId;
 
-    if (!trades.empty()) {
-        const auto ts = clock_.now();
-        for (auto& t : trades) {
-            t.tradeId   = tradeIdGenerator_.next();
-            t.timestamp = ts;
-        }
+    {
+        std::lock_guard<WaitMutex> regLock(registryMutex_);
+        ordersRegistry_.emplace(id, optr);
     }
 
-    symLock.unlock();
+    ScratchLease lease;
+    MatchScratch& scratch = lease.get();
 
-    if (!trades.empty()) {
-        tradeRepo_.add_trades(trades);
-        on_trades(trades);
+    OrderBook& book = entry.book;
+    book.submit_order(o, scratch.fills);
+
+    // a stop that triggered on arrival is handled like any other order here
+    if (!o.isStop && (!rests_on_book(o.tif) || o.remaining == 0)) {
+        release_order(id);
+    }
+    else if (o.has_expiry()) {
+        schedule_expiry(o);
     }
 
+    settle(book, scratch);
+
+    std::vector<Trade>& trades = scratch.trades;
+    to_trades(req.symbol, scratch.fills, trades);
+
+    symLock.unlock();
+
+    publish_trades(trades);
     return id;
 }
 
+OrderId MatchingEngine::new_immediate_order(const NewOrderRequest& req, BookEntry& entry)
+{
+    std::unique_lock<WaitMutex> symLock(entry.mutex);
+
+    Order o;
+    init_order(o, req);
+
+    ScratchLease lease;
+    MatchScratch& scratch = lease.get();
+
+    entry.book.submit_order(o, scratch.fills);
+
+    // stops fired by this order's trades and resting orders it finished
+    settle(entry.book, scratch);
+
+    std::vector<Trade>& trades = scratch.trades;
+    to_trades(req.symbol, scratch.fills, trades);
+
+    symLock.unlock();
+
+    if (riskCheck_) riskCheck_->on_order_closed(o.owner, o.side, o.qty, o.filled);
+
+    publish_trades(trades);
+    return o.orderId;
+}
+
+void MatchingEngine::init_order(Order& o, const NewOrderRequest& req)
+{
+    o.orderId   = orderIdGenerator_.next();
+    o.owner     = req.owner;
+    o.stp       = req.stp;
+    o.symbol    = req.symbol;
+    o.side      = req.side;
+    o.type      = req.type;
+    o.tif       = req.tif;
+    o.price     = req.price;
+    o.qty       = req.quantity;
+    o.remaining = req.quantity;
+    o.filled    = 0;
+    o.timestamp = clock_.now();
+    o.isStop    = req.isStop;
+    o.stopType  = req.stopType;
+    o.stopPrice = req.stopPrice;
+    o.displayQty = req.displayQuantity;
+    o.pegType   = req.pegType;
+    o.pegOffset = req.pegOffset;
+    o.isDark    = req.isDark;
+    o.minQty    = req.minQuantity;
+    if (o.type == OrderType::Market && rests_on_book(o.tif)) {
+        o.tif = TimeInForce::IOC;
+    }
+    if (o.tif == TimeInForce::GTD) {
+        o.expireTime = req.expireTime;
+    }
+    else if (o.tif == TimeInForce::DAY) {
+        o.expireTime = Timestamp{Timestamp::time_point{Timestamp::duration{sessionEndNs_.load(std::memory_order_relaxed)}}};
+    }
+}
+
 bool MatchingEngine::cancel_order(OrderId orderId)
 {
+    poll_expiries();
+
     Symbol sym;
     {
-        std::lock_guard<std::mutex> regLock(registryMutex_);
+        std::lock_guard<WaitMutex> regLock(registryMutex_);
         auto it = ordersRegistry_.find(orderId);
         if (it == ordersRegistry_.end()) return false;
         sym = it->second->symbol;
     }
 
-    std::unique_lock<std::mutex> symLock(*get_or_create_symbol_mutex(sym));
+    BookEntry& entry = books_.get_or_create(sym);
+    std::unique_lock<WaitMutex> symLock(entry.mutex);
 
     Order* optr = nullptr;
     {
-        std::lock_guard<std::mutex> regLock(registryMutex_);
+        std::lock_guard<WaitMutex> regLock(registryMutex_);
         auto it = ordersRegistry_.find(orderId);
         if (it == ordersRegistry_.end()) return false;
-        optr = it->second.get();
+        optr = it->second;
     }
 
-    OrderBook& book = get_or_create_book(sym);
+    OrderBook& book = entry.book;
     const bool removed = book.cancel_order(*optr);
 
     if (removed) {
-        std::lock_guard<std::mutex> regLock(registryMutex_);
-        ordersRegistry_.erase(orderId);
+        release_order(orderId);
         return true;
     }
 
-    {
-        std::lock_guard<std::mutex> regLock(registryMutex_);
-        auto it = ordersRegistry_.find(orderId);
-        if (it != ordersRegistry_.end() && it->second->remaining == 0) {
-            ordersRegistry_.erase(it);
-        }
+    if (optr->remaining == 0) {
+        release_order(orderId);
     }
     return false;
 }
 
 bool MatchingEngine::modify_order(OrderId orderId, const ModifyOrderRequest& req)
 {
+    poll_expiries();
+
+    // only the symbol is needed to find the lock; the order is validated under it
     Symbol sym;
-    Order snapshot;
     {
-        std::lock_guard<std::mutex> regLock(registryMutex_);
+        std::lock_guard<WaitMutex> regLock(registryMutex_);
         auto it = ordersRegistry_.find(orderId);
         if (it == ordersRegistry_.end()) return false;
         sym = it->second->symbol;
-        snapshot = *it->second;
     }
 
-    auto vr = validate_modify_order(snapshot, req);
-    if (vr != orderbook::RejectReason::None) return false;
-
-    std::unique_lock<std::mutex> symLock(*get_or_create_symbol_mutex(sym));
+    BookEntry& entry = books_.get_or_create(sym);
+    std::unique_lock<WaitMutex> symLock(entry.mutex);
 
     Order* optr = nullptr;
     {
-        std::lock_guard<std::mutex> regLock(registryMutex_);
+        std::lock_guard<WaitMutex> regLock(registryMutex_);
         auto it = ordersRegistry_.find(orderId);
         if (it == ordersRegistry_.end()) return false;
-        optr = it->second.get();
+        optr = it->second;
     }
 
-    vr = validate_modify_order(*optr, req);
+    const auto vr = validate_modify_order(*optr, req);
     if (vr != orderbook::RejectReason::None) return false;
 
-    OrderBook& book = get_or_create_book(sym);
+    OrderBook& book = entry.book;
+    if (book.trading_state() == TradingState::Halted) return false;
 
     const bool priceChanged = req.hasNewPrice;
     const Price newPrice = priceChanged ? req.newPrice : optr->price;
 
-    bool willRematch = (optr->type == OrderType::Market);
+    // nothing matches during a call, the amend just requeues; outside one a
+    // repriced dark order is resubmitted to cross at the midpoint
+    const bool inAuction = book.trading_state() == TradingState::Auction;
+    bool willRematch = !inAuction && (optr->type == OrderType::Market || (optr->isDark && priceChanged));
 
-    if (!willRematch && priceChanged) {
+    if (!willRematch && !inAuction && priceChanged) {
         const OrderBookSide& opposite = (optr->side == Side::Buy) ? book.asks() : book.bids();
         const PriceLevel* best = opposite.best_level();
         if (best) {
@@ -181,122 +394,379 @@ bool MatchingEngine::modify_order(OrderId orderId, const ModifyOrderRequest& req
         }
     }
 
+    // reserve a size change up front, undone below if the amend fails; a
+    // peg is sized at its current price
+    Price riskPrice = newPrice;
+    if (optr->is_pegged()) {
+        Price reference = 0.0;
+        riskPrice = orderbook::core::PegBook::reference(optr->pegType, optr->side, book.touch(), reference)
+                  ? reference + optr->pegOffset : 0.0;
+    }
+    const Quantity oldQty = optr->qty;
+    const Quantity newQty = req.hasNewQuantity ? req.newQuantity : oldQty;
+    if (riskCheck_ && newQty != oldQty) {
+        if (riskCheck_->check_resize(optr->owner, optr->side, riskPrice, oldQty, newQty) != orderbook::RejectReason::None) {
+            return false;
+        }
+    }
+    auto undoResize = [&] {
+        if (riskCheck_ && newQty != oldQty) {
+            riskCheck_->release_resize(optr->owner, optr->side, oldQty, newQty);
+        }
+    };
+
     if (!willRematch) {
-        return book.modify_order(*optr, req);
+        if (!book.modify_order(*optr, req)) {
+            undoResize();
+            return false;
+        }
+        // amended down to the filled quantity: nothing left to rest
+        if (optr->remaining == 0) release_order(orderId);
+        return true;
     }
 
-    Order temp = *optr;
-    if (req.hasNewPrice)    temp.price = req.newPrice;
-    if (req.hasNewQuantity) temp.qty   = req.newQuantity;
-    temp.remaining = temp.qty - temp.filled;
+    // only price and quantity change, written to the order once it is out
+    // of the book (its level is still keyed by the old price)
+    const Quantity newRemaining = newQty - optr->filled;
 
-    if (temp.tif == TimeInForce::FOK) {
-        const OrderBookSide& opposite = (temp.side == Side::Buy) ? book.asks() : book.bids();
-        const Quantity avail = opposite.available_quantity_for_order(temp);
-        if (avail < temp.remaining) {
+    if (optr->tif == TimeInForce::FOK) {
+        const OrderBookSide& opposite = (optr->side == Side::Buy) ? book.asks() : book.bids();
+        const Quantity avail = (optr->type == OrderType::Limit) ? opposite.depth_to_price(newPrice)
+                                                                : opposite.total_quantity();
+        if (avail < newRemaining) {
+            undoResize();
             return false;
         }
     }
 
     const bool removed = book.cancel_order(*optr);
     if (!removed) {
-        std::lock_guard<std::mutex> regLock(registryMutex_);
-        auto it = ordersRegistry_.find(orderId);
-        if (it != ordersRegistry_.end() && it->second->remaining == 0) {
-            ordersRegistry_.erase(it);
-        }
+        undoResize();
+        if (optr->remaining == 0) release_order(orderId);
         return false;
     }
 
-    optr->price     = temp.price;
-    optr->qty       = temp.qty;
-    optr->remaining = temp.remaining;
+    optr->price     = newPrice;
+    optr->qty       = newQty;
+    optr->remaining = newRemaining;
 
-    std::vector<Trade> trades = book.submit_order(*optr);
+    ScratchLease lease;
+    MatchScratch& scratch = lease.get();
 
-    if (!trades.empty()) {
-        clean_registry(trades);
-    }
+    book.submit_order(*optr, scratch.fills);
+    if (optr->remaining == 0) release_order(orderId);
 
-    if (!trades.empty()) {
-        const auto ts = clock_.now();
-        for (auto& t : trades) {
-            t.tradeId   = tradeIdGenerator_.next();
-            t.timestamp = ts;
-        }
-    }
+    settle(book, scratch);
 
-    symLock.unlock();
+    std::vector<Trade>& trades = scratch.trades;
+    to_trades(sym, scratch.fills, trades);
 
-    if (!trades.empty()) {
-        tradeRepo_.add_trades(trades);
-        on_trades(trades);
-    }
+    symLock.unlock();
 
+    publish_trades(trades);
     return true;
 }
 
-void MatchingEngine::register_trade_listener(TradeListener listener)
+MatchingEngine::TradeListenerId MatchingEngine::register_trade_listener(TradeListener listener)
 {
     std::lock_guard<std::mutex> lock(listenersMutex_);
-    tradeListeners_.push_back(std::move(listener));
+    const TradeListenerId id = nextTradeListenerId_++;
+    tradeListeners_.emplace_back(id, std::move(listener));
+    return id;
+}
+
+void MatchingEngine::remove_trade_listener(TradeListenerId id)
+{
+    std::lock_guard<std::mutex> lock(listenersMutex_);
+    for (auto it = tradeListeners_.begin(); it != tradeListeners_.end(); ++it) {
+        if (it->first == id) {
+            tradeListeners_.erase(it);
+            return;
+        }
+    }
+}
+
+void MatchingEngine::set_risk_check(IRiskCheck* risk)
+{
+    riskCheck_ = risk;
 }
 
 OrderBook& MatchingEngine::get_or_create_book(const Symbol& symbol)
 {
-    std::lock_guard<std::mutex> lock(booksMutex_);
-    auto& slot = books_[symbol];
-    if (!slot) slot = std::make_unique<OrderBook>();
-    return *slot;
+    return books_.get_or_create(symbol).book;
+}
+
+void MatchingEngine::register_symbols(const std::vector<Symbol>& symbols)
+{
+    books_.reserve_symbols(symbols);
+}
+
+void MatchingEngine::set_match_algorithm(const Symbol& symbol, MatchAlgorithm algorithm)
+{
+    BookEntry& entry = books_.get_or_create(symbol);
+    std::lock_guard<WaitMutex> symLock(entry.mutex);
+    entry.book.set_match_algorithm(algorithm);
+}
+
+void MatchingEngine::set_price_band(const Symbol& symbol, const PriceBand& band)
+{
+    BookEntry& entry = books_.get_or_create(symbol);
+    std::lock_guard<WaitMutex> symLock(entry.mutex);
+    entry.book.set_price_band(band);
+}
+
+void MatchingEngine::enable_dark_book(const Symbol& symbol, DarkPriority priority)
+{
+    BookEntry& entry = books_.get_or_create(symbol);
+    std::lock_guard<WaitMutex> symLock(entry.mutex);
+    entry.book.enable_dark_book(priority);
+}
+
+void MatchingEngine::halt_symbol(const Symbol& symbol)
+{
+    BookEntry& entry = books_.get_or_create(symbol);
+    std::lock_guard<WaitMutex> symLock(entry.mutex);
+    entry.book.halt();
+}
+
+bool MatchingEngine::resume_symbol(const Symbol& symbol)
+{
+    BookEntry& entry = books_.get_or_create(symbol);
+    std::lock_guard<WaitMutex> symLock(entry.mutex);
+    return entry.book.resume();
+}
+
+void MatchingEngine::start_auction(const Symbol& symbol)
+{
+    BookEntry& entry = books_.get_or_create(symbol);
+    std::lock_guard<WaitMutex> symLock(entry.mutex);
+    entry.book.start_auction();
+}
+
+AuctionResult MatchingEngine::indicative_uncross(const Symbol& symbol)
+{
+    BookEntry& entry = books_.get_or_create(symbol);
+    std::lock_guard<WaitMutex> symLock(entry.mutex);
+    return entry.book.indicative_uncross();
+}
+
+AuctionResult MatchingEngine::uncross_auction(const Symbol& symbol)
+{
+    BookEntry& entry = books_.get_or_create(symbol);
+    std::unique_lock<WaitMutex> symLock(entry.mutex);
+    if (entry.book.trading_state() != TradingState::Auction) return AuctionResult{};
+
+    ScratchLease lease;
+    MatchScratch& scratch = lease.get();
+
+    const AuctionResult result = entry.book.uncross(scratch.fills);
+
+    // releases the orders the uncross filled and runs the stops it elected
+    settle(entry.book, scratch);
+
+    std::vector<Trade>& trades = scratch.trades;
+    to_trades(symbol, scratch.fills, trades);
+
+    symLock.unlock();
+
+    publish_trades(trades);
+    return result;
+}
+
+TradingState MatchingEngine::trading_state(const Symbol& symbol) const
+{
+    const BookEntry* entry = books_.find(symbol);
+    return entry ? entry->book.trading_state() : TradingState::Continuous;
+}
+
+void MatchingEngine::publish_trades(const std::vector<Trade>& trades)
+{
+    if (trades.empty()) return;
+
+    tradeRepo_.add_trades(trades);
+    on_trades(trades);
 }
 
 void MatchingEngine::on_trades(const std::vector<Trade>& trades)
 {
-    std::vector<TradeListener> copyTradeListeners;
+    std::vector<std::pair<TradeListenerId, TradeListener>> copyTradeListeners;
     {
         std::lock_guard<std::mutex> lk(listenersMutex_);
         if (tradeListeners_.empty()) return;
         copyTradeListeners = tradeListeners_;
     }
 
-    for (auto& listener : copyTradeListeners) listener(trades);
+    for (auto& entry : copyTradeListeners) entry.second(trades);
+}
+
+void MatchingEngine::run_triggered_stops(OrderBook& book, MatchScratch& scratch)
+{
+    std::vector<Order*>& triggered = scratch.triggered;
+    book.collect_triggered_stops(triggered);
+
+    // stops fired by a triggered order are appended and run in the same pass
+    for (std::size_t i = 0; i < triggered.size(); ++i) {
+        Order& s = *triggered[i];
+        s.timestamp = clock_.now();
+
+        book.submit_order(s, scratch.fills);
+
+        if (!rests_on_book(s.tif) || s.remaining == 0) {
+            release_order(s.orderId);
+        }
+
+        book.collect_triggered_stops(triggered);
+    }
+}
+
+void MatchingEngine::settle(OrderBook& book, MatchScratch& scratch)
+{
+    run_triggered_stops(book, scratch);
+
+    // resting orders the match loop filled or cancelled, reported by handle
+    book.collect_filled_orders(scratch.finished);
+    book.collect_cancelled_orders(scratch.finished);
+    release_orders(scratch.finished);
 }
 
-void MatchingEngine::clean_registry(const std::vector<Trade>& trades)
+void MatchingEngine::to_trades(const Symbol& symbol, const FillBuffer& fills, std::vector<Trade>& trades)
 {
-    std::lock_guard<std::mutex> regLock(registryMutex_);
+    if (fills.empty()) return;
 
-    std::unordered_set<OrderId> ids;
-    for (const auto& t : trades) {
-        if (t.buyOrderId  != orderbook::INVALID_ORDER_ID) ids.insert(t.buyOrderId);
-        if (t.sellOrderId != orderbook::INVALID_ORDER_ID) ids.insert(t.sellOrderId);
+    const auto ts = clock_.now();
+    trades.reserve(fills.size());
+    for (const auto& f : fills) {
+        trades.emplace_back(tradeIdGenerator_.next(), symbol, f.buyOrderId, f.sellOrderId, f.price, f.quantity, ts);
     }
+}
+
+void MatchingEngine::set_session_end(Timestamp sessionEnd)
+{
+    sessionEndNs_.store(sessionEnd.value().time_since_epoch().count(), std::memory_order_relaxed);
+}
+
+void MatchingEngine::expire_orders()
+{
+    const Timestamp now = clock_.now();
+
+    std::vector<TimerWheel::Id> due;
+    {
+        std::lock_guard<std::mutex> lock(expiryMutex_);
+        expiryWheel_.advance(now, due);
+        scheduledExpiries_.store(expiryWheel_.size(), std::memory_order_relaxed);
+        nextExpiryPollNs_.store((now.value() + kExpiryResolution).time_since_epoch().count(), std::memory_order_relaxed);
+    }
+    if (due.empty()) return;
+
+    // stale ids (filled / cancelled since scheduling) simply miss the registry
+    std::unordered_map<Symbol, std::vector<OrderId>> idsBySymbol;
+    {
+        std::lock_guard<WaitMutex> regLock(registryMutex_);
+        for (OrderId id : due) {
+            auto it = ordersRegistry_.find(id);
+            if (it != ordersRegistry_.end()) idsBySymbol[it->second->symbol].push_back(id);
+        }
+    }
+
+    std::vector<Order*> candidates;
+    std::vector<Order*> expired;
+    for (auto& [sym, ids] : idsBySymbol) {
+        BookEntry& entry = books_.get_or_create(sym);
+        std::lock_guard<WaitMutex> symLock(entry.mutex);
+
+        candidates.clear();
+        expired.clear();
+        {
+            std::lock_guard<WaitMutex> regLock(registryMutex_);
+            for (OrderId id : ids) {
+                auto it = ordersRegistry_.find(id);
+                if (it != ordersRegistry_.end()) candidates.push_back(it->second);
+            }
+        }
+
+        entry.book.expire_orders(candidates, now, expired);
 
-    for (auto id : ids) {
-        auto it = ordersRegistry_.find(id);
-        if (it != ordersRegistry_.end() && it->second->remaining == 0) {
-            ordersRegistry_.erase(it);
+        // fired within the deadline's tick but not due yet: check again on the next pass
+        for (Order* o : candidates) {
+            if (o->expireTime > now) schedule_expiry(*o);
         }
+
+        release_orders(expired);
     }
 }
 
-Symbol MatchingEngine::get_symbol_by_order(OrderId orderId) const
+std::size_t MatchingEngine::mass_cancel(const MassCancelRequest& req)
 {
-    std::lock_guard<std::mutex> regLock(registryMutex_);
+    poll_expiries();
+
+    std::vector<BookEntry*> entries;
+    if (req.hasSymbol) {
+        // a symbol never seen has nothing to cancel
+        if (BookEntry* entry = books_.find(req.symbol)) entries.push_back(entry);
+    }
+    else {
+        entries.reserve(books_.size());
+        books_.for_each([&entries](BookEntry& entry) { entries.push_back(&entry); });
+    }
+
+    std::size_t cancelled = 0;
+    std::vector<Order*> removed;
+    for (BookEntry* entry : entries) {
+        std::lock_guard<WaitMutex> symLock(entry->mutex);
+
+        removed.clear();
+        cancelled += entry->book.cancel_orders(req, removed);
+        release_orders(removed);
+    }
+    return cancelled;
+}
+
+void MatchingEngine::release_order(OrderId orderId)
+{
+    std::lock_guard<WaitMutex> regLock(registryMutex_);
     auto it = ordersRegistry_.find(orderId);
-    if (it != ordersRegistry_.end()) return it->second->symbol;
-    return "";
+    if (it == ordersRegistry_.end()) return;
+    const Order& o = *it->second;
+    if (riskCheck_) riskCheck_->on_order_closed(o.owner, o.side, o.qty, o.filled);
+    orderPool_.destroy(it->second);
+    ordersRegistry_.erase(it);
 }
 
-std::mutex* MatchingEngine::get_or_create_symbol_mutex(const Symbol& symbol)
+void MatchingEngine::release_orders(const std::vector<Order*>& orders)
 {
-    std::lock_guard<std::mutex> lock(symbolMutexesGuard_);
-    auto it = symbolMutexes_.find(symbol);
-    if (it != symbolMutexes_.end()) return it->second.get();
+    if (orders.empty()) return;
 
-    auto& ptr = symbolMutexes_[symbol];
-    if (!ptr) ptr = std::make_unique<std::mutex>();
-    return ptr.get();
+    std::lock_guard<WaitMutex> regLock(registryMutex_);
+    for (Order* o : orders) {
+        if (riskCheck_) riskCheck_->on_order_closed(o->owner, o->side, o->qty, o->filled);
+        ordersRegistry_.erase(o->orderId);
+    }
+    orderPool_.destroy_all(orders);
+}
+
+void MatchingEngine::schedule_expiry(const Order& order)
+{
+    std::lock_guard<std::mutex> lock(expiryMutex_);
+    expiryWheel_.schedule(order.orderId, order.expireTime);
+    scheduledExpiries_.store(expiryWheel_.size(), std::memory_order_relaxed);
+}
+
+void MatchingEngine::poll_expiries()
+{
+    if (scheduledExpiries_.load(std::memory_order_relaxed) == 0) return;
+
+    const auto nowNs = clock_.now().value().time_since_epoch().count();
+    if (nowNs < nextExpiryPollNs_.load(std::memory_order_relaxed)) return;
+
+    expire_orders();
+}
+
+Symbol MatchingEngine::get_symbol_by_order(OrderId orderId) const
+{
+    std::lock_guard<WaitMutex> regLock(registryMutex_);
+    auto it = ordersRegistry_.find(orderId);
+    if (it != ordersRegistry_.end()) return it->second->symbol;
+    return "";
 }
 
 }
@@ -39,4 +39,17 @@ void Order::add_fill(Quantity q)
     remaining -= q;
 }
 
+void Order::reduce(Quantity q)
+{
+    if (q <= 0) {
+        return;
+    }
+
+    if (q > remaining) {
+        q = remaining;
+    }
+
+    remaining -= q;
+}
+
 } 
@@ -1,53 +1,421 @@
 #include "orderbook/core/order_book.hpp"
 #include <cassert>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace orderbook::core {
 
 OrderBook::OrderBook()
-    : bids_(Side::Buy),
-      asks_(Side::Sell) 
+    : OrderBook(nullptr)
 {
 }
 
-std::vector<Trade> OrderBook::submit_order(Order& order) 
+OrderBook::OrderBook(std::pmr::memory_resource* upstream)
+    : pool_(upstream ? std::make_unique<std::pmr::unsynchronized_pool_resource>(upstream) : nullptr),
+      memory_(pool_ ? pool_.get() : std::pmr::get_default_resource()),
+      bids_(Side::Buy, memory_),
+      asks_(Side::Sell, memory_),
+      stops_(memory_),
+      pegs_(memory_)
+{
+}
+
+std::size_t OrderBook::submit_order(Order& order, FillBuffer& fills) 
 {
     assert(order.remaining > 0 && "[order book] submit_order called with non-positive remaining quantity");
     assert(order.price >= 0.0 && "[order book] submit_order called with negative price");
 
-    std::vector<Trade> trades;
+    // untriggered stop: park it in the stop book until the trigger trades
+    if (order.isStop) {
+        if (!is_stop_triggered(order)) {
+            stops_.add_order(&order);
+            return 0;
+        }
+        order.isStop = false;
+    }
+
+    // halted: nothing matches or rests (stops elected by the halting trade land here)
+    const TradingState state = trading_state();
+    if (state == TradingState::Halted) {
+        order.reduce(order.remaining);
+        return 0;
+    }
+    if (state == TradingState::Auction) {
+        if (order.type == OrderType::Market || !rests_on_book(order.tif) || order.is_pegged()) {
+            order.reduce(order.remaining);
+            return 0;
+        }
+        if (order.isDark) {
+            dark_->add_order(&order);
+            return 0;
+        }
+        side_of(order.side).add_order(&order);
+        publish_snapshot();
+        return 0;
+    }
+
+    if (order.isDark) return submit_dark_order(order, fills);
 
     OrderBookSide& oppositeBookSide = opposite_side_of(order.side);
     OrderBookSide& bookSide = side_of(order.side);
+    const Side oppositeSide = (order.side == Side::Buy) ? Side::Sell : Side::Buy;
+
+    Price bandLimit = 0.0;
+    const bool banded = band_limit(order.side, bandLimit);
+
+    // pegs are priced off the touch as it stands before this order
+    const bool pegsOpposite = !pegs_.empty(oppositeSide);
+    const BookTouch touch = (pegsOpposite || order.is_pegged()) ? limit_touch() : BookTouch{};
+
+    // an incoming peg matches as a limit at its current price; it cannot
+    // trade while its reference is undefined
+    bool priced = true;
+    if (order.is_pegged()) {
+        Price reference = 0.0;
+        priced = PegBook::reference(order.pegType, order.side, touch, reference);
+        order.price = priced ? reference + order.pegOffset : 0.0;
+    }
 
     // if FOK (Fill-Or-Kill): check available liquidity first
     if (order.tif == TimeInForce::FOK) {
         Quantity avail = oppositeBookSide.available_quantity_for_order(order);
+        if (banded) avail = std::min(avail, oppositeBookSide.depth_to_price(bandLimit));
+        if (pegsOpposite) avail += peg_quantity_for_order(order, touch, banded, bandLimit);
         if (avail < order.remaining) {
             // cannot fully fill immediately -> kill the order (no trades)
-            return trades;
+            return 0;
         }
     }
 
     // match the incoming order against the opposite side
-    oppositeBookSide.match(order, trades);
+    const std::size_t first = fills.size();
+    const Quantity remainingBefore = order.remaining;
+    const std::size_t cancelledBefore = cancelledOrders_.size();
+
+    // midpoint liquidity before or after the lit sweep; FOK stays on the lit book
+    const bool darkOpposite = dark_ && priced && order.tif != TimeInForce::FOK && !dark_->empty(oppositeSide);
+    if (darkOpposite && darkPriority_ == DarkPriority::BeforeLit) match_dark(order, fills);
+
+    bool bandHit = false;
+    if (priced && order.remaining > 0) {
+        bandHit = pegsOpposite ? match_with_pegs(order, fills, bandLimit, touch)
+                               : match_order(oppositeBookSide, order, fills, bandLimit);
+    }
+
+    if (darkOpposite && darkPriority_ == DarkPriority::AfterLit && !bandHit && order.remaining > 0) {
+        match_dark(order, fills);
+    }
+
+    bool changed = order.remaining != remainingBefore || cancelledOrders_.size() != cancelledBefore;
+
+    // the remainder would have to trade through the band: it cannot rest crossed
+    if (bandHit) {
+        order.reduce(order.remaining);
+        if (band_.onBreach == BandBreachAction::Halt) {
+            haltedFrom_ = TradingState::Continuous;
+            state_.store(TradingState::Halted, std::memory_order_release);
+            changed = true;
+        }
+    }
 
     // if there is remaining quantity, add to the book only for GTC
     if (order.remaining > 0) {
-        if (order.tif == TimeInForce::GTC) {
-            bookSide.add_order(&order);
+        if (rests_on_book(order.tif)) {
+            if (order.is_pegged()) {
+                order.price = order.pegOffset;
+                pegs_.add_order(&order);
+            }
+            else {
+                bookSide.add_order(&order);
+            }
+            changed = true;
         } 
         else {
             // IOC: do not add remaining to book; FOK shouldn't reach here when not fully filled
         }
     }
 
-    return trades;
+    // the touch may have moved under resting pegs
+    uncross_pegs(fills);
+    record_fills(fills, first);
+    changed = changed || fills.size() != first;
+
+    // an IOC that found nothing to trade leaves the published view as is
+    if (changed) publish_snapshot();
+    return fills.size() - first;
+}
+
+bool OrderBook::match_order(OrderBookSide& opposite, Order& order, FillBuffer& fills, Price bandLimit)
+{
+    // one dispatch per order; each policy has its own compiled loop
+    switch (matchAlgorithm_) {
+    case MatchAlgorithm::ProRata:
+        return opposite.match<ProRataMatch>(order, fills, filledOrders_, cancelledOrders_, bandLimit);
+    case MatchAlgorithm::ProRataTopOrder:
+        return opposite.match<ProRataTopOrderMatch>(order, fills, filledOrders_, cancelledOrders_, bandLimit);
+    case MatchAlgorithm::SizeTime:
+        return opposite.match<SizeTimeMatch>(order, fills, filledOrders_, cancelledOrders_, bandLimit);
+    case MatchAlgorithm::Fifo:
+    default:
+        return opposite.match<FifoMatch>(order, fills, filledOrders_, cancelledOrders_, bandLimit);
+    }
+}
+
+std::size_t OrderBook::submit_dark_order(Order& order, FillBuffer& fills)
+{
+    assert(dark_ && "[order book] dark order for a book without a dark book");
+
+    const std::size_t first = fills.size();
+    match_dark(order, fills);
+
+    if (order.remaining > 0 && rests_on_book(order.tif)) {
+        dark_->add_order(&order);
+    }
+
+    // dark trades move the last trade price but not the displayed book
+    record_fills(fills, first);
+    if (fills.size() != first) publish_snapshot();
+    return fills.size() - first;
+}
+
+void OrderBook::match_dark(Order& order, FillBuffer& fills)
+{
+    const PriceLevel* bid = bids_.best_level();
+    const PriceLevel* ask = asks_.best_level();
+    if (!bid || !ask) return;
+
+    const Price mid = (bid->price() + ask->price()) / 2.0;
+    if (order.type == OrderType::Limit && (order.side == Side::Buy ? order.price < mid : order.price > mid)) return;
+
+    dark_->match(order, mid, fills, filledOrders_, cancelledOrders_);
+}
+
+void OrderBook::enable_dark_book(DarkPriority priority)
+{
+    if (!dark_) dark_ = std::make_unique<DarkBook>(memory_);
+    darkPriority_ = priority;
+    darkEnabled_.store(true, std::memory_order_release);
+}
+
+bool OrderBook::match_with_pegs(Order& order, FillBuffer& fills, Price bandLimit, const BookTouch& touch)
+{
+    const Side side = (order.side == Side::Buy) ? Side::Sell : Side::Buy;
+    OrderBookSide& limits = opposite_side_of(order.side);
+
+    // whether a is a better price than b for the incoming order
+    const bool buying = order.side == Side::Buy;
+    auto better = [buying](Price a, Price b) { return buying ? a < b : a > b; };
+
+    constexpr PegType kPegTypes[] = {PegType::Primary, PegType::Market, PegType::Midpoint};
+
+    while (order.remaining > 0) {
+        // best price of each source: the limit side, then one per peg type
+        bool  has[4]   = {};
+        Price price[4] = {};
+        Price reference[4] = {};
+        if (const PriceLevel* lv = limits.best_level()) {
+            has[0]   = true;
+            price[0] = lv->price();
+        }
+        for (std::size_t t = 0; t < 3; ++t) {
+            const PriceLevel* lv = pegs_.side(side, kPegTypes[t]).best_level();
+            if (lv && PegBook::reference(kPegTypes[t], side, touch, reference[t + 1])) {
+                has[t + 1]   = true;
+                price[t + 1] = reference[t + 1] + lv->price();
+            }
+        }
+
+        // limit orders first on equal prices
+        std::size_t src = 4;
+        for (std::size_t k = 0; k < 4; ++k) {
+            if (has[k] && (src == 4 || better(price[k], price[src]))) src = k;
+        }
+        if (src == 4) break;
+
+        if (order.type == OrderType::Limit && better(order.price, price[src])) break;
+        if (better(bandLimit, price[src])) return true;
+
+        // sweep this source until another one is better: a peg stops short of
+        // the limit side's price, and everything stops at the band
+        Price cap = bandLimit;
+        for (std::size_t k = 0; k < 4; ++k) {
+            if (k == src || !has[k]) continue;
+            Price c = price[k];
+            if (src != 0 && k == 0) c = std::nextafter(c, buying ? -std::numeric_limits<Price>::infinity()
+                                                                 :  std::numeric_limits<Price>::infinity());
+            if (better(c, cap)) cap = c;
+        }
+
+        const bool stopped = (src == 0)
+            ? match_order(limits, order, fills, cap)
+            : pegs_.side(side, kPegTypes[src - 1]).match<FifoMatch>(order, fills, filledOrders_, cancelledOrders_,
+                                                                    cap, reference[src]);
+        if (stopped && cap == bandLimit) return true;
+    }
+    return false;
+}
+
+Quantity OrderBook::peg_quantity_for_order(const Order& order, const BookTouch& touch, bool banded, Price bandLimit) const
+{
+    const Side side = (order.side == Side::Buy) ? Side::Sell : Side::Buy;
+    Quantity total = 0;
+    for (PegType t : {PegType::Primary, PegType::Market, PegType::Midpoint}) {
+        Price reference = 0.0;
+        if (!PegBook::reference(t, side, touch, reference)) continue;
+
+        const OrderBookSide& pegSide = pegs_.side(side, t);
+        Quantity avail = (order.type == OrderType::Limit) ? pegSide.depth_to_price(order.price - reference)
+                                                          : pegSide.total_quantity();
+        if (banded) avail = std::min(avail, pegSide.depth_to_price(bandLimit - reference));
+        total += avail;
+    }
+    return total;
+}
+
+void OrderBook::uncross_pegs(FillBuffer& fills)
+{
+    if (pegs_.empty(Side::Buy) || pegs_.empty(Side::Sell)) return;
+
+    // only pegs can cross each other: offsets are validated to stay off the opposite touch
+    const BookTouch touch = limit_touch();
+    PegType buyType{}, sellType{};
+    Price   buyPrice = 0.0, sellPrice = 0.0;
+
+    while (pegs_.best(Side::Buy, touch, buyType, buyPrice)
+           && pegs_.best(Side::Sell, touch, sellType, sellPrice)
+           && buyPrice >= sellPrice) {
+        OrderBookSide& buys  = pegs_.side(Side::Buy, buyType);
+        OrderBookSide& sells = pegs_.side(Side::Sell, sellType);
+        const RestingOrder& b = buys.best_level()->front();
+        const RestingOrder& s = sells.best_level()->front();
+
+        // the order resting longer sets the price
+        const Fill fill{b.orderId, s.orderId, b.orderId < s.orderId ? buyPrice : sellPrice,
+                        std::min(b.visible, s.visible)};
+
+        pegAllocations_.clear();
+        buys.execute_auction(fill.quantity, pegAllocations_, filledOrders_);
+        sells.execute_auction(fill.quantity, pegAllocations_, filledOrders_);
+        fills.push(fill);
+    }
+}
+
+BookTouch OrderBook::limit_touch() const
+{
+    BookTouch touch;
+    if (const PriceLevel* lv = bids_.best_level()) touch.bestBid = lv->price();
+    if (const PriceLevel* lv = asks_.best_level()) touch.bestAsk = lv->price();
+    touch.lastTradePrice = lastTradePrice_;
+    return touch;
+}
+
+void OrderBook::set_price_band(const PriceBand& band)
+{
+    band_ = band;
+}
+
+void OrderBook::halt()
+{
+    const TradingState state = trading_state();
+    if (state == TradingState::Halted) return;
+
+    haltedFrom_ = state;
+    state_.store(TradingState::Halted, std::memory_order_release);
+    publish_snapshot();
+}
+
+bool OrderBook::resume()
+{
+    if (trading_state() != TradingState::Halted) return false;
+
+    // a halted call goes back to collecting; only uncross() ends it
+    state_.store(haltedFrom_, std::memory_order_release);
+    publish_snapshot();
+    return true;
+}
+
+void OrderBook::start_auction()
+{
+    state_.store(TradingState::Auction, std::memory_order_release);
+    publish_snapshot();
+}
+
+AuctionResult OrderBook::indicative_uncross() const
+{
+    bids_.auction_levels(auctionBidLevels_);
+    asks_.auction_levels(auctionAskLevels_);
+    if (auctionBidLevels_.empty() || auctionAskLevels_.empty()) return AuctionResult{};
+
+    // last trade, then the band's reference, then the middle of the crossed touch
+    Price reference = lastTradePrice_ > 0.0 ? lastTradePrice_ : band_.referencePrice;
+    if (reference <= 0.0) {
+        reference = (auctionBidLevels_.back().price + auctionAskLevels_.front().price) / 2.0;
+    }
+    return compute_uncross(auctionBidLevels_, auctionAskLevels_, reference);
+}
+
+AuctionResult OrderBook::uncross(FillBuffer& fills)
+{
+    const AuctionResult result = indicative_uncross();
+
+    if (result.volume > 0) {
+        auctionBuys_.clear();
+        auctionSells_.clear();
+        auctionBuys_.reserve(bids_.order_count());
+        auctionSells_.reserve(asks_.order_count());
+        bids_.execute_auction(result.volume, auctionBuys_, filledOrders_);
+        asks_.execute_auction(result.volume, auctionSells_, filledOrders_);
+
+        // pair the two priority lists; both sum to the auction volume
+        const std::size_t first = fills.size();
+        std::size_t b = 0, s = 0;
+        Quantity buyLeft  = auctionBuys_.empty() ? 0 : auctionBuys_[0].quantity;
+        Quantity sellLeft = auctionSells_.empty() ? 0 : auctionSells_[0].quantity;
+        while (b < auctionBuys_.size() && s < auctionSells_.size()) {
+            const Quantity qty = std::min(buyLeft, sellLeft);
+            fills.push(Fill{auctionBuys_[b].orderId, auctionSells_[s].orderId, result.price, qty});
+            buyLeft  -= qty;
+            sellLeft -= qty;
+            if (buyLeft == 0 && ++b < auctionBuys_.size())    buyLeft  = auctionBuys_[b].quantity;
+            if (sellLeft == 0 && ++s < auctionSells_.size())  sellLeft = auctionSells_[s].quantity;
+        }
+        record_fills(fills, first);
+    }
+
+    state_.store(TradingState::Continuous, std::memory_order_release);
+    publish_snapshot();
+    return result;
+}
+
+bool OrderBook::band_limit(Side side, Price& limit) const
+{
+    constexpr Price inf = std::numeric_limits<Price>::infinity();
+    const Price reference = lastTradePrice_ > 0.0 ? lastTradePrice_ : band_.referencePrice;
+    if (!band_.enabled() || reference <= 0.0) {
+        limit = side == Side::Buy ? inf : -inf;
+        return false;
+    }
+    limit = side == Side::Buy ? reference * (1.0 + band_.percent)
+                              : reference * (1.0 - band_.percent);
+    return true;
 }
 
 bool OrderBook::cancel_order(Order& order) 
 {
+    if (order.isStop) {
+        return stops_.remove_order(order);
+    }
+    if (order.is_pegged()) {
+        return pegs_.remove_order(order);
+    }
+    if (order.isDark) {
+        return dark_->remove_order(order);
+    }
+
     OrderBookSide& bookSide = side_of(order.side);
     bool removed = bookSide.remove_order(order);
+    if (removed) publish_snapshot();
     return removed;
 }
 
@@ -58,25 +426,214 @@ bool OrderBook::modify_order(Order& order, const ModifyOrderRequest& req)
         return false; // cannot set quantity less than already filled
     }
 
-    OrderBookSide& bookSide = side_of(order.side);
-    bool removed = bookSide.remove_order(order);
+    // a size-down amend at the same price keeps queue priority and is applied
+    // in place; price changes and size increases lose it through cancel/replace
+    const bool samePrice = !req.hasNewPrice || order.is_pegged() || req.newPrice == order.price;
+    if (samePrice && req.hasNewQuantity && req.newQuantity < order.qty && req.newQuantity > order.filled) {
+        const Quantity cut = order.qty - req.newQuantity;
+        if (!order.isDark) {
+            OrderBookSide& bookSide = order.is_pegged() ? pegs_.side(order.side, order.pegType) : side_of(order.side);
+            if (!bookSide.reduce_order(order, cut)) return false;
+        }
+        order.qty = req.newQuantity;
+        order.remaining -= cut;
+
+        if (!order.isDark) publish_snapshot();
+        return true;
+    }
+
+    // a peg keeps its offset; only its quantity can change
+    OrderBookSide* bookSide = nullptr;
+    bool removed = false;
+    if (order.isDark) {
+        removed = dark_->remove_order(order);
+    }
+    else {
+        bookSide = order.is_pegged() ? &pegs_.side(order.side, order.pegType) : &side_of(order.side);
+        removed = bookSide->remove_order(order);
+    }
 
     if (!removed) {
         assert(false && "[order book] modify_order failed to remove order from book");
         return false; 
     }
 
-    order.price = req.hasNewPrice ? req.newPrice : order.price;
+    order.price = (req.hasNewPrice && !order.is_pegged()) ? req.newPrice : order.price;
     order.qty = req.hasNewQuantity ? req.newQuantity : order.qty;
     order.remaining = order.qty - order.filled;
 
+    // a dark order requeues unmatched and leaves the displayed book as is
+    if (order.isDark) {
+        if (order.remaining > 0) dark_->add_order(&order);
+        return true;
+    }
+
     if (order.remaining > 0) {
-        bookSide.add_order(&order);
+        bookSide->add_order(&order);
     }
 
+    publish_snapshot();
     return true;
 }
 
+std::size_t OrderBook::remove_orders_if(const OrderPredicate& pred, std::vector<Order*>& removed)
+{
+    const std::size_t count = bids_.remove_orders_if(pred, removed)
+                            + asks_.remove_orders_if(pred, removed)
+                            + stops_.remove_orders_if(pred, removed)
+                            + pegs_.remove_orders_if(pred, removed)
+                            + (dark_ ? dark_->remove_orders_if(pred, removed) : 0);
+    if (count > 0) publish_snapshot();
+    return count;
+}
+
+std::size_t OrderBook::cancel_orders(const MassCancelRequest& req, std::vector<Order*>& removed)
+{
+    const Price minPrice = req.hasPriceRange ? req.minPrice : -std::numeric_limits<Price>::infinity();
+    const Price maxPrice = req.hasPriceRange ? req.maxPrice : std::numeric_limits<Price>::infinity();
+
+    OrderPredicate ownerPred;
+    if (req.hasOwner) {
+        const OwnerId owner = req.owner;
+        ownerPred = [owner](const Order& o) { return o.owner == owner; };
+    }
+
+    std::size_t count = 0;
+    if (!req.hasSide || req.side == Side::Buy) {
+        count += bids_.remove_orders_if(minPrice, maxPrice, ownerPred, removed);
+    }
+    if (!req.hasSide || req.side == Side::Sell) {
+        count += asks_.remove_orders_if(minPrice, maxPrice, ownerPred, removed);
+    }
+
+    if (!stops_.empty()) {
+        count += stops_.remove_orders_if([&req, minPrice, maxPrice](const Order& o) {
+            if (req.hasSide && o.side != req.side) return false;
+            if (req.hasOwner && o.owner != req.owner) return false;
+            return o.stopPrice >= minPrice && o.stopPrice <= maxPrice;
+        }, removed);
+    }
+
+    // pegs have no fixed price, so a price range never selects them
+    if (!req.hasPriceRange && !pegs_.empty()) {
+        count += pegs_.remove_orders_if([&req](const Order& o) {
+            if (req.hasSide && o.side != req.side) return false;
+            return !req.hasOwner || o.owner == req.owner;
+        }, removed);
+    }
+
+    if (dark_ && !dark_->empty()) {
+        count += dark_->remove_orders_if([&req, minPrice, maxPrice](const Order& o) {
+            if (req.hasSide && o.side != req.side) return false;
+            if (req.hasOwner && o.owner != req.owner) return false;
+            return o.price >= minPrice && o.price <= maxPrice;
+        }, removed);
+    }
+
+    if (count > 0) publish_snapshot();
+    return count;
+}
+
+void OrderBook::expire_orders(const std::vector<Order*>& candidates, Timestamp now, std::vector<Order*>& expired)
+{
+    auto isExpired = [now](const Order& o) { return o.has_expiry() && o.expireTime <= now; };
+
+    if (candidates.size() * kSweepRatio >= order_count()) {
+        remove_orders_if(isExpired, expired);
+        return;
+    }
+
+    for (Order* o : candidates) {
+        if (!isExpired(*o)) continue;
+        if (cancel_order(*o)) expired.push_back(o);
+    }
+}
+
+DepthSummary OrderBook::depth(DepthLevel* bids, DepthLevel* asks, std::size_t n, bool cumulative) const
+{
+    DepthSummary summary;
+    summary.bidLevels   = bids_.depth(bids, n);
+    summary.askLevels   = asks_.depth(asks, n);
+    summary.bidQuantity = depth_quantity(bids, summary.bidLevels);
+    summary.askQuantity = depth_quantity(asks, summary.askLevels);
+    summary.imbalance   = depth_imbalance(summary.bidQuantity, summary.askQuantity);
+
+    if (cumulative) {
+        accumulate_depth(bids, summary.bidLevels);
+        accumulate_depth(asks, summary.askLevels);
+    }
+    return summary;
+}
+
+void OrderBook::publish_snapshot()
+{
+    BookSnapshot snap;
+    snap.bidDepth       = static_cast<std::uint32_t>(bids_.depth(snap.bids.data(), BookSnapshot::kDepth));
+    snap.askDepth       = static_cast<std::uint32_t>(asks_.depth(snap.asks.data(), BookSnapshot::kDepth));
+    snap.bidOrders      = bids_.order_count();
+    snap.askOrders      = asks_.order_count();
+    snap.lastTradePrice = lastTradePrice_;
+    snap.state          = trading_state();
+    snap.version        = ++snapshotVersion_;
+    snapshot_.store(snap);
+
+    BookTouch touch;
+    touch.bestBid        = snap.bidDepth > 0 ? snap.bids[0].price : 0.0;
+    touch.bestAsk        = snap.askDepth > 0 ? snap.asks[0].price : 0.0;
+    touch.lastTradePrice = lastTradePrice_;
+    touch_.store(touch);
+}
+
+void OrderBook::collect_triggered_stops(std::vector<Order*>& out)
+{
+    if (!hasPendingTrades_) return;
+    hasPendingTrades_ = false;
+
+    if (stops_.empty()) return;
+
+    const std::size_t first = out.size();
+    stops_.collect_triggered(pendingLow_, pendingHigh_, out);
+    for (std::size_t i = first; i < out.size(); ++i) {
+        out[i]->isStop = false;
+    }
+}
+
+void OrderBook::collect_filled_orders(std::vector<Order*>& out)
+{
+    out.insert(out.end(), filledOrders_.begin(), filledOrders_.end());
+    filledOrders_.clear();
+}
+
+void OrderBook::collect_cancelled_orders(std::vector<Order*>& out)
+{
+    out.insert(out.end(), cancelledOrders_.begin(), cancelledOrders_.end());
+    cancelledOrders_.clear();
+}
+
+bool OrderBook::is_stop_triggered(const Order& order) const
+{
+    if (lastTradePrice_ <= 0.0) return false;
+    return (order.side == Side::Buy) ? lastTradePrice_ >= order.stopPrice
+                                     : lastTradePrice_ <= order.stopPrice;
+}
+
+void OrderBook::record_fills(const FillBuffer& fills, std::size_t first)
+{
+    if (fills.size() == first) return;
+
+    if (!hasPendingTrades_) {
+        pendingLow_  = fills[first].price;
+        pendingHigh_ = fills[first].price;
+        hasPendingTrades_ = true;
+    }
+    for (std::size_t i = first; i < fills.size(); ++i) {
+        const Price p = fills[i].price;
+        if (p < pendingLow_)  pendingLow_  = p;
+        if (p > pendingHigh_) pendingHigh_ = p;
+    }
+    lastTradePrice_ = fills.back().price;
+}
+
 OrderBookSide& OrderBook::side_of(Side side) 
 {
     return (side == Side::Buy) ? bids_ : asks_;
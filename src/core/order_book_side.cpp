@@ -1,12 +1,16 @@
 #include "orderbook/core/order_book_side.hpp"
 
 #include <algorithm>
+#include <iterator>
+#include <limits>
 #include <cassert>
 
 namespace orderbook::core {
 
-OrderBookSide::OrderBookSide(Side side)
-    : side_(side) 
+OrderBookSide::OrderBookSide(Side side, std::pmr::memory_resource* resource)
+    : side_(side)
+    , priceLevels_(resource)
+    , depthIndex_(resource)
 {
 }
 
@@ -18,9 +22,12 @@ void OrderBookSide::add_order(Order* order)
     double price = order->price;
     auto it = priceLevels_.find(price);
     if (it == priceLevels_.end()) {
-        it = priceLevels_.emplace(price, PriceLevel(price)).first;
+        it = priceLevels_.try_emplace(price, price).first;
     }
+    const Quantity before = it->second.total_volume();
     it->second.add_order(order);
+    ++orderCount_;
+    index_delta(price, it->second.total_volume() - before);
 }
 
 bool OrderBookSide::remove_order(const Order& order) 
@@ -32,6 +39,7 @@ bool OrderBookSide::remove_order(const Order& order)
     }
     
     PriceLevel& level = it->second;
+    const Quantity before = level.total_volume();
     bool removed = level.remove_order(order.orderId);
     
     if (!removed) {
@@ -39,6 +47,9 @@ bool OrderBookSide::remove_order(const Order& order)
         return false;
     }
     
+    --orderCount_;
+    index_delta(order.price, level.total_volume() - before);
+
     // Clean up empty price level
     if (level.empty()) {
         priceLevels_.erase(it);
@@ -47,16 +58,68 @@ bool OrderBookSide::remove_order(const Order& order)
     return true;
 }
 
-void OrderBookSide::match(Order& incoming, std::vector<Trade>& trades) 
+bool OrderBookSide::reduce_order(const Order& order, Quantity qty)
+{
+    auto it = priceLevels_.find(order.price);
+    if (it == priceLevels_.end() || !it->second.reduce_order(order.orderId, qty)) {
+        assert(false && "[order book side] reduce_order order not found");
+        return false;
+    }
+
+    index_delta(order.price, -qty);
+    return true;
+}
+
+std::size_t OrderBookSide::remove_orders_if(const OrderPredicate& pred, std::vector<Order*>& removed)
+{
+    return remove_orders_if(-std::numeric_limits<Price>::infinity(),
+                            std::numeric_limits<Price>::infinity(), pred, removed);
+}
+
+std::size_t OrderBookSide::remove_orders_if(Price minPrice, Price maxPrice, const OrderPredicate& pred, std::vector<Order*>& removed)
+{
+    std::size_t count = 0;
+    auto end = priceLevels_.upper_bound(maxPrice);
+    for (auto it = priceLevels_.lower_bound(minPrice); it != end; ) {
+        const Quantity before = it->second.total_volume();
+        count += pred ? it->second.remove_orders_if(pred, removed)
+                      : it->second.remove_all_orders(removed);
+        index_delta(it->first, it->second.total_volume() - before);
+        if (it->second.empty()) {
+            it = priceLevels_.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    orderCount_ -= count;
+    return count;
+}
+
+template <typename Policy>
+bool OrderBookSide::match(Order& incoming, FillBuffer& fills, std::vector<Order*>& completed, std::vector<Order*>& cancelled,
+                          Price bandLimit, Price reference)
 {
     assert(incoming.remaining > 0 && "[order book side] match called with non-positive remaining quantity");
     assert((incoming.type == OrderType::Market || incoming.price > 0.0) && "[order book side] limit order match called with negative price");
 
+    // decided once; inside the loop it costs one owner compare on the already loaded resting order
+    const bool preventSelfTrade = incoming.stp != SelfTradePrevention::None && incoming.owner != INVALID_OWNER_ID;
+
+    // the depth index is settled once per level touched, not per fill
+    bool     tracking = false;
+    Price    trackedPrice = 0.0;
+    Quantity trackedBefore = 0;
+    bool     bandHit = false;
+    bool     topPending = false;
+
     while (incoming.remaining > 0) {
         auto it = best_level_it();
         if (it == priceLevels_.end()) break;
 
-        double bestPrice = it->second.price();
+        // levels of a pegged side are keyed by offset from the reference
+        const Price levelPrice = it->second.price();
+        const Price bestPrice  = levelPrice + reference;
         // check limit order price crossing 
         if (incoming.type == OrderType::Limit) {
             if (incoming.side == Side::Buy) {
@@ -72,77 +135,301 @@ void OrderBookSide::match(Order& incoming, std::vector<Trade>& trades)
         }
         
         PriceLevel& level = it->second;
-        Order* resting = level.top_order();
-        assert(resting && "[order book side] best_level_it() should guarantee non-empty level");
+        if (!tracking || trackedPrice != levelPrice) {
+            // entering a new level: the only place the band is checked
+            if (incoming.side == Side::Buy ? bestPrice > bandLimit : bestPrice < bandLimit) {
+                bandHit = true;
+                break;
+            }
+            // only an emptied (and erased) best level lets another one become best
+            if (tracking) index_delta(trackedPrice, -trackedBefore);
+            tracking      = true;
+            trackedPrice  = levelPrice;
+            trackedBefore = level.total_volume();
+            topPending    = Policy::kTopOrderPriority;
+        }
+
+        if constexpr (Policy::kAllocates) {
+            // a level this order cannot clear is shared by the policy; a
+            // self-owned order there is first dealt with in time priority
+            if (!topPending && incoming.remaining < level.volume()
+                && !(preventSelfTrade && level_has_owner(level, incoming.owner))) {
+                allocate_level<Policy>(incoming, it, bestPrice, fills, completed);
+                break;
+            }
+            topPending = false;
+        }
+
+        RestingOrder& resting = level.front();
+
+        if (preventSelfTrade && resting.owner == incoming.owner) {
+            const SelfTradePrevention mode = incoming.stp;
+            if (mode == SelfTradePrevention::CancelIncoming) {
+                incoming.reduce(incoming.remaining);
+                break;
+            }
+
+            Order* restingOrder = resting.order;
+            if (mode == SelfTradePrevention::Decrement) {
+                const Quantity decQty = std::min(incoming.remaining, resting.visible);
+                incoming.reduce(decQty);
+                restingOrder->reduce(decQty);
+                resting.visible -= decQty;
+                level.update_volume(decQty);
+            }
+            else {
+                if (mode == SelfTradePrevention::CancelBoth) incoming.reduce(incoming.remaining);
+                level.remove_top_order();
+                --orderCount_;
+                cancelled.push_back(restingOrder);
+                clean_side(it);
+                continue;
+            }
+
+            if (restingOrder->remaining == 0) {
+                level.remove_top_order();
+                --orderCount_;
+                cancelled.push_back(restingOrder);
+                clean_side(it);
+            }
+            else if (resting.visible == 0) {
+                level.replenish_top_order();
+            }
+            continue;
+        }
 
-        // trade price is resting order price
-        Quantity matchQty = std::min(incoming.remaining, resting->remaining);
-        double tradePrice = resting->price; 
+        // trade price is the level price, only the displayed peak is matchable
+        const Quantity matchQty = std::min(incoming.remaining, resting.visible);
 
-        // update order's filled / remaining
         incoming.add_fill(matchQty);
-        resting->add_fill(matchQty);
-
-        // record trade
-        Trade trade;
-        trade.symbol = incoming.symbol;
-        trade.price = tradePrice;
-        trade.quantity = matchQty;
-        trade.timestamp = incoming.timestamp; // temp, will be updated later
+        resting.visible -= matchQty;
+        level.update_volume(matchQty);
+
         if (incoming.side == Side::Buy) {
-            trade.buyOrderId = incoming.orderId;
-            trade.sellOrderId = resting->orderId;
+            fills.push(Fill{incoming.orderId, resting.orderId, bestPrice, matchQty});
         } 
         else {
-            trade.buyOrderId = resting->orderId;
-            trade.sellOrderId = incoming.orderId;
+            fills.push(Fill{resting.orderId, incoming.orderId, bestPrice, matchQty});
+        }
+
+        if (resting.is_iceberg()) {
+            // the reserve lives on the full order, keep it current to size the next peak
+            Order* restingOrder = resting.order;
+            restingOrder->add_fill(matchQty);
+            if (restingOrder->remaining == 0) {
+                level.remove_top_order();
+                --orderCount_;
+                completed.push_back(restingOrder);
+                clean_side(it);
+            }
+            else if (resting.visible == 0) {
+                level.replenish_top_order();
+            }
+            continue;
         }
-        trades.push_back(trade);
 
-        if (resting->remaining == 0) {
+        // plain order: visible == remaining, the full order is updated after the sweep
+        pendingFills_.push_back(PendingFill{resting.order, matchQty});
+        if (resting.visible == 0) {
+            completed.push_back(resting.order);
             level.remove_top_order();
+            --orderCount_;
             clean_side(it);
-        } 
+        }
+    }
+
+    if (tracking) {
+        auto lv = priceLevels_.find(trackedPrice);
+        const Quantity after = (lv != priceLevels_.end()) ? lv->second.total_volume() : 0;
+        index_delta(trackedPrice, after - trackedBefore);
+    }
+
+    for (const auto& fill : pendingFills_) {
+        fill.order->add_fill(fill.qty);
+    }
+    pendingFills_.clear();
+
+    return bandHit;
+}
+
+template <typename Policy>
+void OrderBookSide::allocate_level(Order& incoming, PriceLevels::iterator it, Price price, FillBuffer& fills,
+                                   std::vector<Order*>& completed)
+{
+    PriceLevel& level = it->second;
+    auto& queue = level.orders();
+
+    Policy::allocate(queue, incoming.remaining, level.volume(), allocation_);
+
+    for (std::size_t i = 0; i < queue.size(); ++i) {
+        const Quantity qty = allocation_.alloc[i];
+        if (qty == 0) continue;
+
+        RestingOrder& resting = queue[i];
+        incoming.add_fill(qty);
+        resting.visible -= qty;
+        level.update_volume(qty);
+
+        if (incoming.side == Side::Buy) {
+            fills.push(Fill{incoming.orderId, resting.orderId, price, qty});
+        }
+        else {
+            fills.push(Fill{resting.orderId, incoming.orderId, price, qty});
+        }
+
+        if (resting.is_iceberg()) {
+            resting.order->add_fill(qty);
+        }
         else {
-            level.update_volume(matchQty);
+            pendingFills_.push_back(PendingFill{resting.order, qty});
         }
     }
+
+    orderCount_ -= level.remove_exhausted(completed, allocation_.requeue);
+    clean_side(it);
 }
 
-Quantity OrderBookSide::available_quantity_for_order(const Order& incoming) const 
+bool OrderBookSide::level_has_owner(const PriceLevel& level, OwnerId owner)
 {
-    Quantity total = 0;
+    for (const auto& r : level.orders()) {
+        if (r.owner == owner) return true;
+    }
+    return false;
+}
 
-    if (priceLevels_.empty()) return 0;
 
-    if (incoming.type == OrderType::Limit) {
-        if (side_ == Side::Sell) {
-            for (auto it = priceLevels_.begin(); it != priceLevels_.end(); ++it) {
-                double p = it->first;
-                if (p > incoming.price) break;
-                total += it->second.volume(); 
-                if (total >= incoming.remaining) return total;
+void OrderBookSide::auction_levels(std::vector<AuctionLevel>& out) const
+{
+    out.clear();
+    out.reserve(priceLevels_.size());
+    for (const auto& [price, level] : priceLevels_) {
+        if (!level.empty()) out.push_back(AuctionLevel{price, level.total_volume()});
+    }
+}
+
+void OrderBookSide::execute_auction(Quantity qty, std::vector<AuctionAllocation>& out, std::vector<Order*>& completed)
+{
+    while (qty > 0) {
+        auto it = best_level_it();
+        assert(it != priceLevels_.end() && "[order book side] execute_auction ran out of levels");
+        if (it == priceLevels_.end()) break;
+
+        PriceLevel& level = it->second;
+        const Price    price  = level.price();
+        const Quantity before = level.total_volume();
+
+        // same per-order steps as match, without price or self-trade checks
+        while (qty > 0 && !level.empty()) {
+            RestingOrder& resting = level.front();
+            const Quantity take = std::min(qty, resting.visible);
+            Order* order = resting.order;
+
+            qty -= take;
+            resting.visible -= take;
+            level.update_volume(take);
+            order->add_fill(take);
+            out.push_back(AuctionAllocation{resting.orderId, take});
+
+            if (order->remaining == 0) {
+                level.remove_top_order();
+                --orderCount_;
+                completed.push_back(order);
             }
-        } 
-        else { 
-            for (auto it = priceLevels_.rbegin(); it != priceLevels_.rend(); ++it) {
-                double p = it->first;
-                if (p < incoming.price) break;
-                total += it->second.volume();  
-                if (total >= incoming.remaining) return total;
+            else if (resting.visible == 0) {
+                level.replenish_top_order();
             }
         }
-    } 
-    else {
-        for (auto& kv : priceLevels_) {
-            total += kv.second.volume();  
-            if (total >= incoming.remaining) return total;
+
+        index_delta(price, level.total_volume() - before);
+        clean_side(it);
+    }
+}
+
+Quantity OrderBookSide::available_quantity_for_order(const Order& incoming) const 
+{
+    if (incoming.type == OrderType::Limit) {
+        return depth_to_price(incoming.price);
+    }
+    return depthIndex_.total();
+}
+
+Quantity OrderBookSide::depth_to_price(Price price) const
+{
+    // asks are better when lower, bids when higher
+    if (side_ == Side::Sell) {
+        return quantity_below(price, true);
+    }
+    return depthIndex_.total() - quantity_below(price, false);
+}
+
+bool OrderBookSide::price_for_quantity(Quantity qty, Price& worstPrice) const
+{
+    const Quantity total = depthIndex_.total();
+    if (qty <= 0 || qty > total) return false;
+
+    // the answer is the level whose ascending inclusive prefix first exceeds threshold
+    const Quantity threshold = (side_ == Side::Sell) ? qty - 1 : total - qty;
+
+    Quantity acc = 0;
+    const DepthIndex::Bucket b = depthIndex_.first_exceeding(threshold, acc);
+
+    auto it = priceLevels_.lower_bound(depthIndex_.bucket_floor(b));
+    while (it != priceLevels_.begin() && depthIndex_.bucket_of(std::prev(it)->first) >= b) --it;
+    while (it != priceLevels_.end() && depthIndex_.bucket_of(it->first) < b) ++it;
+
+    for (; it != priceLevels_.end(); ++it) {
+        acc += it->second.total_volume();
+        if (acc > threshold) {
+            worstPrice = it->first;
+            return true;
         }
     }
 
+    assert(false && "[order book side] depth index out of step with price levels");
+    return false;
+}
+
+Quantity OrderBookSide::quantity_below(Price price, bool inclusive) const
+{
+    // whole buckets from the index, then the levels of the boundary bucket exactly
+    const DepthIndex::Bucket b = depthIndex_.bucket_of(price);
+    Quantity total = depthIndex_.sum_before(b);
+
+    auto it = inclusive ? priceLevels_.upper_bound(price) : priceLevels_.lower_bound(price);
+    while (it != priceLevels_.begin()) {
+        --it;
+        if (depthIndex_.bucket_of(it->first) != b) break;
+        total += it->second.total_volume();
+    }
     return total;
 }
 
+void OrderBookSide::index_delta(Price price, Quantity delta)
+{
+    if (delta == 0) return;
+    if (!depthIndex_.covers(price)) {
+        // the rebuild reads the levels as they are now, delta included
+        rebuild_depth_index(price);
+        return;
+    }
+    depthIndex_.add(price, delta);
+}
+
+void OrderBookSide::rebuild_depth_index(Price price)
+{
+    Price lo = price;
+    Price hi = price;
+    if (!priceLevels_.empty()) {
+        lo = std::min(lo, priceLevels_.begin()->first);
+        hi = std::max(hi, priceLevels_.rbegin()->first);
+    }
+
+    depthIndex_.reset(lo, hi);
+    for (const auto& [p, level] : priceLevels_) {
+        if (level.total_volume() != 0) depthIndex_.add(p, level.total_volume());
+    }
+}
+
 PriceLevel* OrderBookSide::best_level() 
 {
     auto it = best_level_it();
@@ -157,50 +444,28 @@ const PriceLevel* OrderBookSide::best_level() const
     return &it->second;
 }
 
-std::vector<PriceLevel*> OrderBookSide::top_k_levels(std::size_t k) 
+std::vector<const PriceLevel*> OrderBookSide::top_k_levels(std::size_t k) const
 {
-    std::vector<PriceLevel*> levels;
+    std::vector<const PriceLevel*> levels;
     if (k == 0 || priceLevels_.empty()) return levels;
 
-    if (side_ == Side::Buy) {
-        for (auto it = priceLevels_.rbegin(); it != priceLevels_.rend() && levels.size() < k; ++it) {
-            if (!it->second.empty()) {
-                levels.push_back(&it->second);
-            }
-        }
-    } 
-    else {
-        for (auto it = priceLevels_.begin(); it != priceLevels_.end() && levels.size() < k; ++it) {
-            if (!it->second.empty()) {
-                levels.push_back(&it->second);
-            }
-        }
-    }
-
+    levels.reserve(std::min(k, priceLevels_.size()));
+    for_each_best_level(k, [&levels](const PriceLevel& level) { levels.push_back(&level); });
     return levels;
 }
 
-std::vector<const PriceLevel*> OrderBookSide::top_k_levels(std::size_t k) const
+std::size_t OrderBookSide::depth(DepthLevel* out, std::size_t n, bool cumulative) const
 {
-    std::vector<const PriceLevel*> levels;
-    if (k == 0 || priceLevels_.empty()) return levels;
+    std::size_t count = 0;
+    for_each_best_level(n, [out, &count](const PriceLevel& level) {
+        out[count].price      = level.price();
+        out[count].quantity   = level.volume();
+        out[count].orderCount = static_cast<std::uint32_t>(level.size());
+        ++count;
+    });
 
-    if (side_ == Side::Buy) {
-        for (auto it = priceLevels_.rbegin(); it != priceLevels_.rend() && levels.size() < k; ++it) {
-            if (!it->second.empty()) {
-                levels.push_back(&it->second);
-            }
-        }
-    } 
-    else {
-        for (auto it = priceLevels_.begin(); it != priceLevels_.end() && levels.size() < k; ++it) {
-            if (!it->second.empty()) {
-                levels.push_back(&it->second);
-            }
-        }
-    }
-
-    return levels;
+    if (cumulative) accumulate_depth(out, count);
+    return count;
 }
 
 OrderBookSide::PriceLevels::iterator OrderBookSide::best_level_it() 
@@ -249,4 +514,10 @@ void OrderBookSide::clean_side(PriceLevels::iterator it) {
     }
 }
 
+// the policies of MatchAlgorithm
+template bool OrderBookSide::match<FifoMatch>(Order&, FillBuffer&, std::vector<Order*>&, std::vector<Order*>&, Price, Price);
+template bool OrderBookSide::match<ProRataMatch>(Order&, FillBuffer&, std::vector<Order*>&, std::vector<Order*>&, Price, Price);
+template bool OrderBookSide::match<ProRataTopOrderMatch>(Order&, FillBuffer&, std::vector<Order*>&, std::vector<Order*>&, Price, Price);
+template bool OrderBookSide::match<SizeTimeMatch>(Order&, FillBuffer&, std::vector<Order*>&, std::vector<Order*>&, Price, Price);
+
 } 
@@ -0,0 +1,91 @@
+#include "orderbook/core/peg_book.hpp"
+
+#include <cassert>
+
+namespace orderbook::core {
+
+PegBook::PegBook(std::pmr::memory_resource* resource)
+    : bids_{OrderBookSide(Side::Buy, resource), OrderBookSide(Side::Buy, resource), OrderBookSide(Side::Buy, resource)}
+    , asks_{OrderBookSide(Side::Sell, resource), OrderBookSide(Side::Sell, resource), OrderBookSide(Side::Sell, resource)}
+{
+}
+
+OrderBookSide& PegBook::side(Side side, PegType type)
+{
+    assert(type != PegType::None && "[peg book] side of an unpegged type");
+    return side == Side::Buy ? bids_[index_of(type)] : asks_[index_of(type)];
+}
+
+const OrderBookSide& PegBook::side(Side side, PegType type) const
+{
+    assert(type != PegType::None && "[peg book] side of an unpegged type");
+    return side == Side::Buy ? bids_[index_of(type)] : asks_[index_of(type)];
+}
+
+std::size_t PegBook::order_count(Side side) const noexcept
+{
+    const auto& sides = side == Side::Buy ? bids_ : asks_;
+    return sides[0].order_count() + sides[1].order_count() + sides[2].order_count();
+}
+
+void PegBook::add_order(Order* order)
+{
+    side(order->side, order->pegType).add_order(order);
+}
+
+bool PegBook::remove_order(const Order& order)
+{
+    return side(order.side, order.pegType).remove_order(order);
+}
+
+std::size_t PegBook::remove_orders_if(const OrderPredicate& pred, std::vector<Order*>& removed)
+{
+    std::size_t count = 0;
+    for (auto& s : bids_) count += s.remove_orders_if(pred, removed);
+    for (auto& s : asks_) count += s.remove_orders_if(pred, removed);
+    return count;
+}
+
+bool PegBook::reference(PegType type, Side side, const BookTouch& touch, Price& out)
+{
+    const bool hasBid = touch.bestBid > 0.0;
+    const bool hasAsk = touch.bestAsk > 0.0;
+
+    switch (type) {
+    case PegType::Primary:
+        if (side == Side::Buy ? !hasBid : !hasAsk) return false;
+        out = side == Side::Buy ? touch.bestBid : touch.bestAsk;
+        return true;
+    case PegType::Market:
+        if (side == Side::Buy ? !hasAsk : !hasBid) return false;
+        out = side == Side::Buy ? touch.bestAsk : touch.bestBid;
+        return true;
+    case PegType::Midpoint:
+        if (!hasBid || !hasAsk) return false;
+        out = (touch.bestBid + touch.bestAsk) / 2.0;
+        return true;
+    case PegType::None:
+    default:
+        return false;
+    }
+}
+
+bool PegBook::best(Side side, const BookTouch& touch, PegType& type, Price& price) const
+{
+    bool found = false;
+    for (PegType t : {PegType::Primary, PegType::Market, PegType::Midpoint}) {
+        const PriceLevel* level = this->side(side, t).best_level();
+        Price ref = 0.0;
+        if (!level || !reference(t, side, touch, ref)) continue;
+
+        const Price p = ref + level->price();
+        if (!found || (side == Side::Buy ? p > price : p < price)) {
+            found = true;
+            type  = t;
+            price = p;
+        }
+    }
+    return found;
+}
+
+}
@@ -1,11 +1,14 @@
 #include "orderbook/core/price_level.hpp"
+#include <algorithm>
 #include <cassert>
 
 namespace orderbook::core {
 
-PriceLevel::PriceLevel(double price)
+PriceLevel::PriceLevel(double price, const allocator_type& alloc)
     : price_(price)
     , volume_(0)
+    , hiddenVolume_(0)
+    , ordersQueue_(alloc)
 {
 }
 
@@ -13,31 +16,60 @@ void PriceLevel::add_order(Order* o)
 {
     if (!o) return;
     if (o->remaining <= 0) return;  
-    ordersQueue_.push_back(o);   
-    volume_ += o->remaining;
+
+    RestingOrder r;
+    r.orderId = o->orderId;
+    r.visible = (o->is_iceberg() && o->displayQty < o->remaining) ? o->displayQty : o->remaining;
+    r.order   = o;
+    r.owner   = o->owner;
+    r.flags   = o->is_iceberg() ? RestingOrder::kIceberg : 0;
+
+    ordersQueue_.push_back(r);   
+    volume_       += r.visible;
+    hiddenVolume_ += hidden_of(r);
 }
 
 Order* PriceLevel::top_order() {
     if (ordersQueue_.empty()) return nullptr;
-    return ordersQueue_.front();
+    return ordersQueue_.front().order;
 }
 
 const Order* PriceLevel::top_order() const {
     if (ordersQueue_.empty()) return nullptr;
-    return ordersQueue_.front();
+    return ordersQueue_.front().order;
 }
 
 void PriceLevel::remove_top_order() {
     if (!ordersQueue_.empty()) {
-        volume_ -= ordersQueue_.front()->remaining;
+        const RestingOrder& r = ordersQueue_.front();
+        volume_       -= r.visible;
+        hiddenVolume_ -= hidden_of(r);
         ordersQueue_.pop_front();
     }
 }
 
+void PriceLevel::replenish_top_order() {
+    if (ordersQueue_.empty()) return;
+
+    RestingOrder r = ordersQueue_.front();
+    const Order* o = r.order;
+    assert(r.visible == 0 && o->remaining > 0 && "[price level] replenish_top_order on order with displayed quantity");
+
+    const Quantity peak = (o->displayQty < o->remaining) ? o->displayQty : o->remaining;
+    r.visible      = peak;
+    volume_       += peak;
+    hiddenVolume_ -= peak;
+
+    // a new peak loses time priority
+    ordersQueue_.pop_front();
+    ordersQueue_.push_back(r);
+}
+
 bool PriceLevel::remove_order(OrderId orderId) {
     for (auto it = ordersQueue_.begin(); it != ordersQueue_.end(); ++it) {
-        if ((*it) && (*it)->orderId == orderId) {
-            volume_ -= (*it)->remaining;
+        if (it->orderId == orderId) {
+            volume_       -= it->visible;
+            hiddenVolume_ -= hidden_of(*it);
             ordersQueue_.erase(it);
             return true;
         }
@@ -45,6 +77,81 @@ bool PriceLevel::remove_order(OrderId orderId) {
     return false;
 }
 
+bool PriceLevel::reduce_order(OrderId orderId, Quantity qty) {
+    for (auto& r : ordersQueue_) {
+        if (r.orderId != orderId) continue;
+        assert(qty < r.order->remaining && "[price level] reduce_order would leave nothing remaining");
+
+        const Quantity hiddenCut = std::min(qty, hidden_of(r));
+        r.visible     -= qty - hiddenCut;
+        volume_       -= qty - hiddenCut;
+        hiddenVolume_ -= hiddenCut;
+        return true;
+    }
+    return false;
+}
+
+std::size_t PriceLevel::remove_orders_if(const OrderPredicate& pred, std::vector<Order*>& removed) {
+    const std::size_t before = removed.size();
+
+    auto keep = ordersQueue_.begin();
+    for (auto it = ordersQueue_.begin(); it != ordersQueue_.end(); ++it) {
+        if (pred(*it->order)) {
+            volume_       -= it->visible;
+            hiddenVolume_ -= hidden_of(*it);
+            removed.push_back(it->order);
+        }
+        else {
+            *keep++ = *it;
+        }
+    }
+    ordersQueue_.erase(keep, ordersQueue_.end());
+
+    return removed.size() - before;
+}
+
+std::size_t PriceLevel::remove_all_orders(std::vector<Order*>& removed) {
+    const std::size_t count = ordersQueue_.size();
+    removed.reserve(removed.size() + count);
+    for (const auto& r : ordersQueue_) removed.push_back(r.order);
+    ordersQueue_.clear();
+    volume_       = 0;
+    hiddenVolume_ = 0;
+    return count;
+}
+
+std::size_t PriceLevel::remove_exhausted(std::vector<Order*>& completed, std::vector<RestingOrder>& requeue) {
+    std::size_t unlinked = 0;
+    requeue.clear();
+
+    auto keep = ordersQueue_.begin();
+    for (auto it = ordersQueue_.begin(); it != ordersQueue_.end(); ++it) {
+        if (it->visible > 0) {
+            *keep++ = *it;
+            continue;
+        }
+        // a plain order's full record is updated after the sweep: visible == remaining
+        if (it->is_iceberg() && it->order->remaining > 0) {
+            requeue.push_back(*it);
+        }
+        else {
+            completed.push_back(it->order);
+            ++unlinked;
+        }
+    }
+    ordersQueue_.erase(keep, ordersQueue_.end());
+
+    for (RestingOrder r : requeue) {
+        const Order* o = r.order;
+        const Quantity peak = (o->displayQty < o->remaining) ? o->displayQty : o->remaining;
+        r.visible      = peak;
+        volume_       += peak;
+        hiddenVolume_ -= peak;
+        ordersQueue_.push_back(r);
+    }
+    return unlinked;
+}
+
 void PriceLevel::update_volume(Quantity filledQty) {
     assert(filledQty <= volume_ && "[price level] update_volume would make volume negative");
     volume_ -= filledQty;
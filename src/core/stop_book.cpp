@@ -0,0 +1,102 @@
+#include "orderbook/core/stop_book.hpp"
+#include <cassert>
+
+namespace orderbook::core {
+
+namespace {
+
+template <typename StopMap>
+bool remove_from(StopMap& stops, const Order& order)
+{
+    auto it = stops.find(order.stopPrice);
+    if (it == stops.end()) return false;
+
+    auto& queue = it->second;
+    for (auto qit = queue.begin(); qit != queue.end(); ++qit) {
+        if ((*qit)->orderId == order.orderId) {
+            queue.erase(qit);
+            if (queue.empty()) stops.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename StopMap>
+std::size_t remove_from_if(StopMap& stops, const OrderPredicate& pred, std::vector<Order*>& removed)
+{
+    std::size_t count = 0;
+    for (auto it = stops.begin(); it != stops.end(); ) {
+        auto& queue = it->second;
+        auto keep = queue.begin();
+        for (auto qit = queue.begin(); qit != queue.end(); ++qit) {
+            if (pred(**qit)) {
+                removed.push_back(*qit);
+                ++count;
+            }
+            else {
+                *keep++ = *qit;
+            }
+        }
+        queue.erase(keep, queue.end());
+
+        if (queue.empty()) {
+            it = stops.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    return count;
+}
+
+}
+
+void StopBook::add_order(Order* order)
+{
+    if (!order) return;
+    assert(order->isStop && "[stop book] add_order called with non-stop order");
+
+    if (order->side == Side::Buy) {
+        buyStops_[order->stopPrice].push_back(order);
+    }
+    else {
+        sellStops_[order->stopPrice].push_back(order);
+    }
+    ++size_;
+}
+
+bool StopBook::remove_order(const Order& order)
+{
+    const bool removed = (order.side == Side::Buy) ? remove_from(buyStops_, order)
+                                                   : remove_from(sellStops_, order);
+    if (removed) --size_;
+    return removed;
+}
+
+std::size_t StopBook::remove_orders_if(const OrderPredicate& pred, std::vector<Order*>& removed)
+{
+    const std::size_t count = remove_from_if(buyStops_, pred, removed)
+                            + remove_from_if(sellStops_, pred, removed);
+    size_ -= count;
+    return count;
+}
+
+void StopBook::collect_triggered(Price low, Price high, std::vector<Order*>& out)
+{
+    while (!buyStops_.empty() && buyStops_.begin()->first <= high) {
+        auto it = buyStops_.begin();
+        for (Order* o : it->second) out.push_back(o);
+        size_ -= it->second.size();
+        buyStops_.erase(it);
+    }
+
+    while (!sellStops_.empty() && sellStops_.begin()->first >= low) {
+        auto it = sellStops_.begin();
+        for (Order* o : it->second) out.push_back(o);
+        size_ -= it->second.size();
+        sellStops_.erase(it);
+    }
+}
+
+}
@@ -0,0 +1,115 @@
+#include "orderbook/core/symbol_directory.hpp"
+
+#include <bit>
+#include <cassert>
+
+namespace orderbook::core {
+
+SymbolDirectory::Table::Table(std::size_t capacity)
+    : mask(capacity - 1)
+    , slots(std::make_unique<std::atomic<BookEntry*>[]>(capacity))
+{
+    assert(std::has_single_bit(capacity) && "[symbol directory] table capacity must be a power of two");
+    for (std::size_t i = 0; i < capacity; ++i) {
+        slots[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+SymbolDirectory::SymbolDirectory(std::size_t expectedSymbols, orderbook::util::WaitStrategy lockWait,
+                                 BookMemory memory)
+    : table_(nullptr)
+    , lockWait_(lockWait)
+    , memory_(std::move(memory))
+{
+    // keep the load factor at or below one half
+    const std::size_t capacity = std::bit_ceil(expectedSymbols < 8 ? std::size_t{16} : expectedSymbols * 2);
+    tables_.push_back(std::make_unique<Table>(capacity));
+    table_.store(tables_.back().get(), std::memory_order_release);
+}
+
+SymbolDirectory::~SymbolDirectory() = default;
+
+BookEntry* SymbolDirectory::find(const Symbol& symbol) const noexcept
+{
+    const Table* table = table_.load(std::memory_order_acquire);
+    return probe(*table, symbol, std::hash<Symbol>{}(symbol));
+}
+
+BookEntry& SymbolDirectory::get_or_create(const Symbol& symbol)
+{
+    if (BookEntry* entry = find(symbol)) return *entry;
+
+    std::lock_guard<std::mutex> lock(insertMutex_);
+    return insert_locked(symbol);
+}
+
+void SymbolDirectory::reserve_symbols(const std::vector<Symbol>& symbols)
+{
+    std::lock_guard<std::mutex> lock(insertMutex_);
+    for (const auto& symbol : symbols) insert_locked(symbol);
+}
+
+void SymbolDirectory::for_each(const std::function<void(BookEntry&)>& fn) const
+{
+    const Table* table = table_.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i <= table->mask; ++i) {
+        if (BookEntry* entry = table->slots[i].load(std::memory_order_acquire)) fn(*entry);
+    }
+}
+
+BookEntry& SymbolDirectory::insert_locked(const Symbol& symbol)
+{
+    const std::size_t hash = std::hash<Symbol>{}(symbol);
+
+    // another thread may have inserted it between our lookup and the lock
+    if (BookEntry* entry = probe(*table_.load(std::memory_order_relaxed), symbol, hash)) return *entry;
+
+    if ((size_.load(std::memory_order_relaxed) + 1) * 2 > table_.load(std::memory_order_relaxed)->mask + 1) {
+        grow_locked();
+    }
+
+    entries_.push_back(std::make_unique<BookEntry>(symbol, lockWait_, memory_ ? memory_(symbol) : nullptr));
+    BookEntry* entry = entries_.back().get();
+
+    Table& table = *table_.load(std::memory_order_relaxed);
+    for (std::size_t i = hash & table.mask; ; i = (i + 1) & table.mask) {
+        if (table.slots[i].load(std::memory_order_relaxed) == nullptr) {
+            // release: a reader that sees the pointer sees a constructed entry
+            table.slots[i].store(entry, std::memory_order_release);
+            break;
+        }
+    }
+    size_.fetch_add(1, std::memory_order_release);
+    return *entry;
+}
+
+void SymbolDirectory::grow_locked()
+{
+    const Table& old = *table_.load(std::memory_order_relaxed);
+    auto bigger = std::make_unique<Table>((old.mask + 1) * 2);
+
+    for (std::size_t i = 0; i <= old.mask; ++i) {
+        BookEntry* entry = old.slots[i].load(std::memory_order_relaxed);
+        if (!entry) continue;
+        for (std::size_t j = std::hash<Symbol>{}(entry->symbol) & bigger->mask; ; j = (j + 1) & bigger->mask) {
+            if (bigger->slots[j].load(std::memory_order_relaxed) == nullptr) {
+                bigger->slots[j].store(entry, std::memory_order_relaxed);
+                break;
+            }
+        }
+    }
+
+    tables_.push_back(std::move(bigger));
+    table_.store(tables_.back().get(), std::memory_order_release);
+}
+
+BookEntry* SymbolDirectory::probe(const Table& table, const Symbol& symbol, std::size_t hash) noexcept
+{
+    for (std::size_t i = hash & table.mask; ; i = (i + 1) & table.mask) {
+        BookEntry* entry = table.slots[i].load(std::memory_order_acquire);
+        if (!entry) return nullptr;
+        if (entry->symbol == symbol) return entry;
+    }
+}
+
+}
@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "orderbook/core/matching_engine.hpp"
+#include "orderbook/core/async_engine.hpp"
+#include "orderbook/util/detached_task.hpp"
+#include "orderbook/util/simulated_clock.hpp"
+#include "orderbook/report/internal_trade_repository.hpp"
+
+using namespace orderbook;
+using namespace orderbook::core;
+using namespace orderbook::api;
+using orderbook::util::DetachedTask;
+
+namespace {
+
+struct Totals {
+    std::size_t sessions{0};   // client coroutines still running
+    std::size_t accepted{0};
+    std::size_t rejected{0};
+    std::size_t trades{0};
+    std::size_t cancelled{0};
+};
+
+// one client session: alternate buys and sells around 100, cancel
+// whatever is left resting of every other order
+DetachedTask client_session(AsyncEngine& async, const Symbol& symbol, int orders, int seed, Totals& totals)
+{
+    for (int i = 0; i < orders; ++i) {
+        const Side side = ((i + seed) & 1) ? Side::Buy : Side::Sell;
+        const Price price = 100.0 + (side == Side::Buy ? -0.01 : 0.01) * ((i * 7 + seed) % 5) + (i % 3 == 0 ? (side == Side::Buy ? 0.05 : -0.05) : 0.0);
+        NewOrderRequest req(symbol, side, OrderType::Limit, TimeInForce::GTC, price, 10);
+
+        SubmitResult r = co_await async.submit(req);
+        if (r.order.orderId == INVALID_ORDER_ID) {
+            ++totals.rejected;
+            continue;
+        }
+        ++totals.accepted;
+        totals.trades += r.trades.size();
+
+        if (i % 2 == 0 && co_await async.cancel(r.order)) ++totals.cancelled;
+    }
+    --totals.sessions;
+}
+
+}
+
+// A single gateway thread running many client sessions as coroutines
+// against an AsyncEngine. Every session keeps one request in flight, so
+// up to <sessions> requests are outstanding at once while the gateway
+// thread only ever waits for completions.
+int main(int argc, char** argv)
+{
+    const int sessions = (argc > 1) ? std::atoi(argv[1]) : 10000;
+    const int orders   = (argc > 2) ? std::atoi(argv[2]) : 20;
+    const int shards   = (argc > 3) ? std::atoi(argv[3]) : 4;
+    const int symbols  = (argc > 4) ? std::atoi(argv[4]) : 64;
+
+    orderbook::util::SimulatedClock clock;
+    orderbook::report::InternalTradeRepository repo;
+    MatchingEngine engine(clock, repo);
+
+    std::vector<Symbol> universe;
+    for (int s = 0; s < symbols; ++s) universe.push_back("SYM" + std::to_string(s));
+    engine.register_symbols(universe);
+
+    AsyncEngine::Options options;
+    options.shards = static_cast<std::size_t>(shards);
+    AsyncEngine async(engine, options);
+
+    Totals totals;
+    totals.sessions = static_cast<std::size_t>(sessions);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int c = 0; c < sessions; ++c) {
+        client_session(async, universe[static_cast<std::size_t>(c % symbols)], orders, c, totals);
+    }
+
+    std::size_t maxInFlight = async.in_flight();
+    std::size_t requests = 0;
+    while (totals.sessions > 0) {
+        maxInFlight = std::max(maxInFlight, async.in_flight());
+        requests += async.wait();
+    }
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "sessions=" << sessions << " orders/session=" << orders << " shards=" << shards
+              << " symbols=" << symbols << "\n"
+              << "requests:      " << requests << " in " << secs << "s (" << static_cast<double>(requests) / secs << "/s)\n"
+              << "max in flight: " << maxInFlight << "\n"
+              << "accepted " << totals.accepted << "  rejected " << totals.rejected
+              << "  trades " << totals.trades << "  cancelled " << totals.cancelled << "\n";
+    return 0;
+}
@@ -1,111 +1,403 @@
+#include <algorithm>
 #include <atomic>
 #include <chrono>
-#include <mutex>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
 #include <random>
+#include <sstream>
+#include <string>
 #include <thread>
 #include <vector>
-#include <iostream>
 
 #include "orderbook/core/matching_engine.hpp"
 #include "orderbook/api/new_order_request.hpp"
 #include "orderbook/api/modify_order_request.hpp"
 
 #include "orderbook/util/simulated_clock.hpp"
-#include "orderbook/report/internal_trade_repository.hpp"
+#include "orderbook/util/thread_affinity.hpp"
+#include "orderbook/util/wait_strategy.hpp"
+#include "orderbook/report/i_trade_repository.hpp"
 
 using namespace orderbook;
 using namespace orderbook::core;
 using namespace orderbook::api;
 using namespace orderbook::util;
-using namespace orderbook::report;
 
-int main() {
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+// keeps storage out of the measurement
+class NullTradeRepository : public orderbook::report::ITradeRepository {
+public:
+    void add_trades(const std::vector<Trade>&) override {}
+    std::vector<Trade> trades_between(const Symbol&, Timestamp, Timestamp) override { return {}; }
+    std::vector<Trade> trades_all(const Symbol&) override { return {}; }
+};
+
+enum Op { OpNew, OpIoc, OpCancel, OpModify, OpCount };
+
+const char* const kOpNames[OpCount] = {"new gtc", "new ioc", "cancel ", "modify "};
+
+struct Config {
+    int         threads{8};
+    int         symbols{16};
+    double      seconds{10.0};
+    double      rate{0.0};       // requests per second per thread, 0 = closed loop
+    double      zipf{0.0};       // symbol skew exponent, 0 = uniform
+    std::string prices{"normal"};
+    double      spreadTicks{20.0};
+    int         mix[OpCount]{50, 10, 25, 15};
+    std::vector<int> cpus;       // worker i runs on cpus[i % size], empty = unpinned
+    WaitStrategy wait{WaitStrategy::Blocking};
+    std::size_t pool{0};
+    std::size_t arenaMb{0};
+};
+
+void usage()
+{
+    std::cout << "usage: multithread_test [--threads N] [--symbols N] [--seconds S] [--rate R]\n"
+                 "                        [--zipf S] [--prices normal|uniform] [--spread TICKS]\n"
+                 "                        [--mix NEW,IOC,CANCEL,MODIFY] [--cpus LIST]\n"
+                 "                        [--wait block|yield|spin] [--pool N] [--arena-mb MB]\n"
+                 "  --rate   per-thread arrival rate (req/s); latency is measured from the\n"
+                 "           scheduled send time. 0 runs closed loop\n"
+                 "  --zipf   symbol popularity exponent, 0 picks symbols uniformly\n"
+                 "  --spread price spread around each symbol's mid, in 0.01 ticks\n"
+                 "  --mix    relative weights of the request types\n"
+                 "  --cpus   comma separated CPUs to pin the workers to; the engine's books\n"
+                 "           and order pool are placed on the first one's NUMA node\n"
+                 "  --wait   how workers wait for engine locks and the open-loop schedule\n"
+                 "  --pool   order slots to preallocate\n"
+                 "  --arena-mb huge-page arena for the order pool and price levels\n";
+}
+
+bool parse_mix(const std::string& text, int (&mix)[OpCount])
+{
+    std::istringstream in(text);
+    std::string field;
+    int i = 0;
+    while (std::getline(in, field, ',')) {
+        if (i == OpCount) return false;
+        mix[i++] = std::atoi(field.c_str());
+    }
+    return i == OpCount;
+}
+
+bool parse_cpus(const std::string& text, std::vector<int>& cpus)
+{
+    std::istringstream in(text);
+    std::string field;
+    while (std::getline(in, field, ',')) {
+        if (field.empty()) return false;
+        cpus.push_back(std::atoi(field.c_str()));
+    }
+    return !cpus.empty();
+}
+
+bool parse_wait(const std::string& text, WaitStrategy& wait)
+{
+    if      (text == "block") wait = WaitStrategy::Blocking;
+    else if (text == "yield") wait = WaitStrategy::SpinYield;
+    else if (text == "spin")  wait = WaitStrategy::BusySpin;
+    else return false;
+    return true;
+}
+
+const char* wait_name(WaitStrategy wait)
+{
+    switch (wait) {
+    case WaitStrategy::SpinYield: return "yield";
+    case WaitStrategy::BusySpin:  return "spin";
+    case WaitStrategy::Blocking:
+    default:                      return "block";
+    }
+}
+
+bool parse_args(int argc, char** argv, Config& cfg)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string key = argv[i];
+        if (key == "--help" || i + 1 >= argc) return false;
+        const char* value = argv[++i];
+
+        if      (key == "--threads") cfg.threads     = std::atoi(value);
+        else if (key == "--symbols") cfg.symbols     = std::atoi(value);
+        else if (key == "--seconds") cfg.seconds     = std::atof(value);
+        else if (key == "--rate")    cfg.rate        = std::atof(value);
+        else if (key == "--zipf")    cfg.zipf        = std::atof(value);
+        else if (key == "--prices")  cfg.prices      = value;
+        else if (key == "--spread")  cfg.spreadTicks = std::atof(value);
+        else if (key == "--pool")    cfg.pool        = static_cast<std::size_t>(std::atoll(value));
+        else if (key == "--arena-mb") cfg.arenaMb    = static_cast<std::size_t>(std::atoll(value));
+        else if (key == "--mix") {
+            if (!parse_mix(value, cfg.mix)) return false;
+        }
+        else if (key == "--cpus") {
+            if (!parse_cpus(value, cfg.cpus)) return false;
+        }
+        else if (key == "--wait") {
+            if (!parse_wait(value, cfg.wait)) return false;
+        }
+        else return false;
+    }
+    return cfg.threads > 0 && cfg.symbols > 0 && cfg.seconds > 0.0
+        && (cfg.prices == "normal" || cfg.prices == "uniform");
+}
+
+// an order a thread placed and may still rest
+struct LiveOrder {
+    OrderId     id;
+    std::size_t sym;
+    Side        side;
+};
+
+// per-thread results; latencies in ns, one vector per request type
+struct WorkerStats {
+    std::vector<std::int64_t> latency[OpCount];
+    std::uint64_t rejected[OpCount]{};
+    std::uint64_t late{0};   // open loop: requests sent after their scheduled time
+};
+
+void print_report(const Config& cfg, std::vector<WorkerStats>& stats, double elapsedSec)
+{
+    std::cout << "threads=" << cfg.threads << " symbols=" << cfg.symbols << " zipf=" << cfg.zipf
+              << " prices=" << cfg.prices << " mix=" << cfg.mix[OpNew] << ',' << cfg.mix[OpIoc] << ','
+              << cfg.mix[OpCancel] << ',' << cfg.mix[OpModify];
+    if (cfg.rate > 0.0) std::cout << " rate=" << cfg.rate << "/s/thread (open loop)";
+    else                std::cout << " closed loop";
+    std::cout << " wait=" << wait_name(cfg.wait);
+    if (!cfg.cpus.empty()) {
+        std::cout << " cpus=";
+        for (std::size_t i = 0; i < cfg.cpus.size(); ++i) std::cout << (i ? "," : "") << cfg.cpus[i];
+        const int node = numa_node_of_cpu(cfg.cpus.front());
+        if (node >= 0) std::cout << " home-node=" << node;
+    }
+    std::cout << "\n";
+
+    std::uint64_t total = 0;
+    std::uint64_t late = 0;
+    std::cout << std::fixed << std::setprecision(0);
+    for (int op = 0; op < OpCount; ++op) {
+        std::vector<std::int64_t> ns;
+        std::uint64_t rejected = 0;
+        for (auto& s : stats) {
+            ns.insert(ns.end(), s.latency[op].begin(), s.latency[op].end());
+            rejected += s.rejected[op];
+        }
+        if (ns.empty()) continue;
+        total += ns.size();
+
+        std::sort(ns.begin(), ns.end());
+        double sum = 0;
+        for (auto v : ns) sum += static_cast<double>(v);
+        auto pct = [&ns](double p) { return ns[static_cast<std::size_t>(p * static_cast<double>(ns.size() - 1))]; };
+
+        std::cout << kOpNames[op]
+                  << "  n " << ns.size()
+                  << "  " << static_cast<double>(ns.size()) / elapsedSec << "/s"
+                  << "  rejected " << rejected
+                  << "  mean " << sum / static_cast<double>(ns.size())
+                  << "  p50 " << pct(0.50)
+                  << "  p90 " << pct(0.90)
+                  << "  p99 " << pct(0.99)
+                  << "  p99.9 " << pct(0.999)
+                  << "  max " << ns.back()
+                  << "  (ns)\n";
+    }
+    for (auto& s : stats) late += s.late;
+
+    std::cout << "total " << total << " requests in " << std::setprecision(2) << elapsedSec << "s  "
+              << std::setprecision(0) << static_cast<double>(total) / elapsedSec << " req/s";
+    if (cfg.rate > 0.0) std::cout << "  sent late " << late;
+    std::cout << "\n";
+}
+
+}
+
+// Load generator for MatchingEngine. Each thread draws requests from its own
+// RNG and tracks the orders it owns, dropping an id once a cancel or amend
+// finds it gone (filled, or cancelled by the engine). Symbols are picked
+// uniformly or with a Zipf skew, prices around a per-symbol mid. With --rate
+// the threads follow a fixed arrival schedule and latency runs from the
+// scheduled send time, so a stalled engine is charged for the requests that
+// queued behind the stall (no coordinated omission).
+int main(int argc, char** argv)
+{
+    Config cfg;
+    if (!parse_args(argc, argv, cfg)) {
+        usage();
+        return 1;
+    }
+
+    std::vector<Symbol> symbols;
+    std::vector<double> weights;
+    std::vector<Price>  mids;
+    for (int s = 0; s < cfg.symbols; ++s) {
+        symbols.push_back("SYM" + std::to_string(s));
+        weights.push_back(1.0 / std::pow(static_cast<double>(s + 1), cfg.zipf));
+        mids.push_back(100.0 + s);
+    }
+
+    EngineConfig engineCfg;
+    engineCfg.symbols           = symbols;
+    engineCfg.orderPoolCapacity = cfg.pool;
+    engineCfg.homeCpu           = cfg.cpus.empty() ? -1 : cfg.cpus.front();
+    engineCfg.lockWait          = cfg.wait;
+    engineCfg.hugePageArenaBytes = cfg.arenaMb << 20;
+
     SimulatedClock clock;
-    InternalTradeRepository repo;
-    MatchingEngine eng(clock, repo);
+    NullTradeRepository repo;
+    MatchingEngine eng(clock, repo, engineCfg);
+
+    int mixTotal = 0;
+    for (int w : cfg.mix) mixTotal += w;
+    if (mixTotal <= 0) {
+        usage();
+        return 1;
+    }
 
-    const Symbol sym = "AAPL";
+    const auto duration = std::chrono::duration_cast<SteadyClock::duration>(std::chrono::duration<double>(cfg.seconds));
+    const auto interval = cfg.rate > 0.0
+        ? std::chrono::duration_cast<SteadyClock::duration>(std::chrono::duration<double>(1.0 / cfg.rate))
+        : SteadyClock::duration::zero();
 
-    std::mutex ids_mtx;
-    std::vector<OrderId> live_ids;
-    
-    std::atomic<bool> stop{false};
+    std::vector<WorkerStats> stats(static_cast<std::size_t>(cfg.threads));
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    SteadyClock::time_point start;
 
     auto worker = [&](int tid) {
-        std::mt19937_64 rng((uint64_t)std::chrono::high_resolution_clock::now().time_since_epoch().count() ^ (uint64_t)tid);
-        std::uniform_int_distribution<int> opdist(0, 99);
+        // pin before touching anything so the thread's buffers are node-local
+        if (!cfg.cpus.empty()) {
+            const int cpu = cfg.cpus[static_cast<std::size_t>(tid) % cfg.cpus.size()];
+            if (!pin_current_thread(cpu)) std::cerr << "thread " << tid << ": cannot pin to cpu " << cpu << "\n";
+        }
+
+        WorkerStats& st = stats[static_cast<std::size_t>(tid)];
+        const std::size_t expected = cfg.rate > 0.0 ? static_cast<std::size_t>(cfg.rate * cfg.seconds) : std::size_t{1} << 20;
+        for (int op = 0; op < OpCount; ++op) {
+            st.latency[op].reserve(expected * static_cast<std::size_t>(cfg.mix[op]) / static_cast<std::size_t>(mixTotal) + 16);
+        }
+
+        std::mt19937_64 rng(0x9E3779B97F4A7C15ull ^ static_cast<std::uint64_t>(tid));
+        std::discrete_distribution<int> opdist(std::begin(cfg.mix), std::end(cfg.mix));
+        std::discrete_distribution<std::size_t> symdist(weights.begin(), weights.end());
         std::uniform_int_distribution<int> sidedist(0, 1);
-        std::uniform_int_distribution<int> qtydist(1, 50);
-        std::uniform_real_distribution<double> pricedist(90.0, 110.0);
+        std::uniform_int_distribution<Quantity> qtydist(1, 50);
+        std::normal_distribution<double> normalTicks(0.0, cfg.spreadTicks / 2.0);
+        std::uniform_real_distribution<double> uniformTicks(-cfg.spreadTicks, cfg.spreadTicks);
+        const bool normalPrices = cfg.prices == "normal";
 
-        while (!stop.load(std::memory_order_relaxed)) {
-            int op = opdist(rng);
+        std::vector<LiveOrder> live;
+        live.reserve(1 << 16);
 
-            if (op < 55) {
-                // 55% new order
-                NewOrderRequest req;
-                req.symbol   = sym;
-                req.side     = (sidedist(rng) == 0) ? Side::Buy : Side::Sell;
-                req.type     = OrderType::Limit;
-                req.tif      = TimeInForce::GTC;
-                req.price    = pricedist(rng);
-                req.quantity = qtydist(rng);
-
-                OrderId id = eng.new_order(req);
-                if (id != INVALID_ORDER_ID) {
-                    std::lock_guard<std::mutex> lk(ids_mtx);
-                    live_ids.push_back(id);
-                }
-            } 
-            else if (op < 80) {
-                // 25% cancel
-                OrderId id = INVALID_ORDER_ID;
-                {
-                    std::lock_guard<std::mutex> lk(ids_mtx);
-                    if (!live_ids.empty()) {
-                        id = live_ids[rng() % live_ids.size()];
-                    }
+        auto price_for = [&](std::size_t sym, Side side, bool aggressive) {
+            const double ticks = normalPrices ? std::fabs(normalTicks(rng)) : std::fabs(uniformTicks(rng));
+            const double offset = 0.01 * (1.0 + std::round(ticks));
+            // passive orders sit at least a tick on their own side of the mid,
+            // aggressive ones the same distance across it
+            const bool belowMid = (side == Side::Buy) != aggressive;
+            const double px = belowMid ? mids[sym] - offset : mids[sym] + offset;
+            return std::max(px, 0.01);
+        };
+        auto pick_live = [&](std::size_t& slot) -> const LiveOrder& {
+            slot = static_cast<std::size_t>(rng() % live.size());
+            return live[slot];
+        };
+        auto drop_live = [&](std::size_t slot) {
+            live[slot] = live.back();
+            live.pop_back();
+        };
+
+        ready.fetch_add(1);
+        while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+
+        const auto end = start + duration;
+        auto scheduled = start;
+
+        while (true) {
+            if (cfg.rate > 0.0) {
+                scheduled += interval;
+                if (scheduled >= end) break;
+                auto now = SteadyClock::now();
+                if (now > scheduled) ++st.late;
+                if (cfg.wait == WaitStrategy::Blocking && now < scheduled) {
+                    std::this_thread::sleep_until(scheduled);
+                    now = SteadyClock::now();
                 }
-                if (id != INVALID_ORDER_ID) {
-                    eng.cancel_order(id);
+                while (now < scheduled) {
+                    if (cfg.wait == WaitStrategy::BusySpin) cpu_relax();
+                    else                                    std::this_thread::yield();
+                    now = SteadyClock::now();
                 }
-            } 
+            }
+            else {
+                scheduled = SteadyClock::now();
+                if (scheduled >= end) break;
+            }
+
+            int op = opdist(rng);
+            if ((op == OpCancel || op == OpModify) && live.empty()) op = OpNew;
+
+            bool ok = true;
+            if (op == OpNew || op == OpIoc) {
+                const std::size_t sym = symdist(rng);
+                const Side side = sidedist(rng) == 0 ? Side::Buy : Side::Sell;
+                NewOrderRequest req(symbols[sym], side, OrderType::Limit,
+                                    op == OpNew ? TimeInForce::GTC : TimeInForce::IOC,
+                                    price_for(sym, side, op == OpIoc), qtydist(rng));
+                const OrderId id = eng.new_order(req);
+                ok = id != INVALID_ORDER_ID;
+                if (ok && op == OpNew) live.push_back(LiveOrder{id, sym, side});
+            }
+            else if (op == OpCancel) {
+                std::size_t slot = 0;
+                ok = eng.cancel_order(pick_live(slot).id);
+                drop_live(slot);
+            }
             else {
-                // 20% modify
-                OrderId id = INVALID_ORDER_ID;
-                {
-                    std::lock_guard<std::mutex> lk(ids_mtx);
-                    if (!live_ids.empty()) {
-                        id = live_ids[rng() % live_ids.size()];
-                    }
+                std::size_t slot = 0;
+                const LiveOrder target = pick_live(slot);
+                ModifyOrderRequest mreq;
+                if ((rng() & 1) == 0) {
+                    mreq.hasNewQuantity = true;
+                    mreq.newQuantity = qtydist(rng);
                 }
-                if (id != INVALID_ORDER_ID) {
-                    ModifyOrderRequest mreq;
-                    // randomly modify qty or price
-                    if ((rng() & 1) == 0) {
-                        mreq.hasNewQuantity = true;
-                        mreq.newQuantity = qtydist(rng);
-                    } else {
-                        mreq.hasNewPrice = true;
-                        mreq.newPrice = pricedist(rng);
-                    }
-                    eng.modify_order(id, mreq);
+                else {
+                    mreq.hasNewPrice = true;
+                    mreq.newPrice = price_for(target.sym, target.side, false);
                 }
+                ok = eng.modify_order(target.id, mreq);
+                if (!ok) drop_live(slot);
             }
+
+            st.latency[op].push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(SteadyClock::now() - scheduled).count());
+            if (!ok) ++st.rejected[op];
         }
     };
 
-    const int num_threads = 8;
     std::vector<std::thread> threads;
-    threads.reserve(num_threads);
-
-    for (int i = 0; i < num_threads; ++i) threads.emplace_back(worker, i);
+    threads.reserve(static_cast<std::size_t>(cfg.threads));
+    for (int i = 0; i < cfg.threads; ++i) threads.emplace_back(worker, i);
 
-    std::this_thread::sleep_for(std::chrono::seconds(10));
-    stop.store(true);
+    while (ready.load() < cfg.threads) std::this_thread::yield();
+    start = SteadyClock::now();
+    go.store(true, std::memory_order_release);
 
     for (auto& t : threads) t.join();
+    const double elapsedSec = std::chrono::duration<double>(SteadyClock::now() - start).count();
 
-    std::cout << "stress test done\n";
+    print_report(cfg, stats, elapsedSec);
+    if (const HugePageArena* arena = eng.memory_arena()) {
+        const char* backing = arena->backing() == PageBacking::Explicit    ? "huge pages"
+                            : arena->backing() == PageBacking::Transparent ? "transparent huge pages"
+                                                                           : "normal pages";
+        std::cout << "arena " << (arena->capacity() >> 20) << "MB on " << backing
+                  << ", used " << (arena->used() >> 20) << "MB, overflow allocations " << arena->overflow_count() << "\n";
+    }
     return 0;
 }
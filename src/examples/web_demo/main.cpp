@@ -50,36 +50,32 @@ bool parse_tif(const std::string& s, orderbook::TimeInForce& out) {
 }
 
 std::string orderbook_to_json(const orderbook::core::OrderBook& book) {
+    // lock-free copy, matching may keep running while we format
+    const orderbook::core::BookSnapshot snap = book.snapshot();
+    const std::uint32_t depth = 5;
+
     std::ostringstream json;
     json << "{";
     
     // Get bids 
-    const auto& bidSide = book.bids();
-    auto bidLevels = bidSide.top_k_levels(5);
     json << "\"bids\":[";
-    bool firstBid = true;
-    for (const auto* level : bidLevels) {
-        if (!level) continue;
-        if (!firstBid) json << ",";
-        json << "{\"price\":" << level->price() 
-             << ",\"quantity\":" << level->volume()
-             << ",\"orders\":" << level->size() << "}";
-        firstBid = false;
+    for (std::uint32_t i = 0; i < snap.bidDepth && i < depth; ++i) {
+        const auto& level = snap.bids[i];
+        if (i > 0) json << ",";
+        json << "{\"price\":" << level.price 
+             << ",\"quantity\":" << level.quantity
+             << ",\"orders\":" << level.orderCount << "}";
     }
     json << "],";
     
     // Get asks 
-    const auto& askSide = book.asks();
-    auto askLevels = askSide.top_k_levels(5);
     json << "\"asks\":[";
-    bool firstAsk = true;
-    for (const auto* level : askLevels) {
-        if (!level) continue;
-        if (!firstAsk) json << ",";
-        json << "{\"price\":" << level->price()
-             << ",\"quantity\":" << level->volume()
-             << ",\"orders\":" << level->size() << "}";
-        firstAsk = false;
+    for (std::uint32_t i = 0; i < snap.askDepth && i < depth; ++i) {
+        const auto& level = snap.asks[i];
+        if (i > 0) json << ",";
+        json << "{\"price\":" << level.price
+             << ",\"quantity\":" << level.quantity
+             << ",\"orders\":" << level.orderCount << "}";
     }
     json << "]}";
     
@@ -1,12 +1,27 @@
 #include "orderbook/report/internal_trade_repository.hpp"
 
+#include <tuple>
+
 namespace orderbook::report {
 
 void InternalTradeRepository::add_trades(const std::vector<Trade>& trades) 
 {
     std::lock_guard<std::mutex> lock(mutex_);
+
+    // trades usually come in runs of one symbol: look each run up once
+    TradesBySymbol::iterator it = tradesBySymbol_.end();
     for (const auto& trade : trades) {
-        tradesBySymbol_[trade.symbol].push_back(trade);
+        if (it == tradesBySymbol_.end() || std::string_view(it->first) != std::string_view(trade.symbol)) {
+            it = tradesBySymbol_.find(std::string_view(trade.symbol));
+            if (it == tradesBySymbol_.end()) {
+                // key and vector are built in place with the map's resource
+                it = tradesBySymbol_.emplace(std::piecewise_construct,
+                                             std::forward_as_tuple(trade.symbol.data(), trade.symbol.size()),
+                                             std::forward_as_tuple()).first;
+            }
+        }
+        it->second.push_back(StoredTrade{trade.tradeId, trade.buyOrderId, trade.sellOrderId,
+                                         trade.price, trade.quantity, trade.timestamp});
     }
 }
 
@@ -15,12 +30,12 @@ std::vector<Trade> InternalTradeRepository::trades_between(const Symbol& symbol,
     std::lock_guard<std::mutex> lock(mutex_);
     std::vector<Trade> result;
     
-    auto it = tradesBySymbol_.find(symbol);
+    auto it = tradesBySymbol_.find(std::string_view(symbol));
     if (it == tradesBySymbol_.end()) return result;
     
     for (const auto& t : it->second) {
         if (t.timestamp >= start && t.timestamp <= end) {
-            result.push_back(t);
+            result.push_back(to_trade(symbol, t));
         }
     }
     return result;
@@ -30,10 +45,18 @@ std::vector<Trade> InternalTradeRepository::trades_all(const Symbol& symbol)
 {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    auto it = tradesBySymbol_.find(symbol);
+    auto it = tradesBySymbol_.find(std::string_view(symbol));
     if (it == tradesBySymbol_.end()) return std::vector<Trade>();
     
-    return it->second;
+    std::vector<Trade> result;
+    result.reserve(it->second.size());
+    for (const auto& t : it->second) result.push_back(to_trade(symbol, t));
+    return result;
+}
+
+Trade InternalTradeRepository::to_trade(const Symbol& symbol, const StoredTrade& t)
+{
+    return Trade(t.tradeId, symbol, t.buyOrderId, t.sellOrderId, t.price, t.quantity, t.timestamp);
 }
 
 } 
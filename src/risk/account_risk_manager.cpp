@@ -0,0 +1,195 @@
+#include "orderbook/risk/account_risk_manager.hpp"
+
+#include <bit>
+#include <cmath>
+
+namespace orderbook::risk {
+
+namespace {
+
+std::size_t slot_of(OwnerId owner, std::size_t mask)
+{
+    // Fibonacci hashing spreads sequential account ids
+    return static_cast<std::size_t>((static_cast<std::uint64_t>(owner) * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+}
+
+// last trade, or the touch on the side the order would trade against
+Price reference_price(const orderbook::core::BookTouch& touch, Side side)
+{
+    if (touch.lastTradePrice > 0.0) return touch.lastTradePrice;
+    return (side == Side::Buy) ? touch.bestAsk : touch.bestBid;
+}
+
+}
+
+AccountRiskManager::AccountRiskManager(std::size_t maxAccounts)
+    : mask_(std::bit_ceil(maxAccounts < 8 ? std::size_t{16} : maxAccounts * 2) - 1)
+    , slots_(std::make_unique<std::atomic<Account*>[]>(mask_ + 1))
+    , maxAccounts_(maxAccounts)
+{
+    for (std::size_t i = 0; i <= mask_; ++i) slots_[i].store(nullptr, std::memory_order_relaxed);
+}
+
+AccountRiskManager::~AccountRiskManager() = default;
+
+bool AccountRiskManager::set_limits(OwnerId owner, const RiskLimits& limits)
+{
+    std::lock_guard<std::mutex> lock(insertMutex_);
+
+    if (Account* a = find(owner)) {
+        a->limits.store(limits);
+        return true;
+    }
+    if (accounts_.size() >= maxAccounts_) return false;
+
+    accounts_.push_back(std::make_unique<Account>(owner));
+    Account* a = accounts_.back().get();
+    a->limits.store(limits);
+
+    for (std::size_t i = slot_of(owner, mask_); ; i = (i + 1) & mask_) {
+        if (slots_[i].load(std::memory_order_relaxed) == nullptr) {
+            slots_[i].store(a, std::memory_order_release);
+            break;
+        }
+    }
+    return true;
+}
+
+bool AccountRiskManager::account(OwnerId owner, AccountView& out) const
+{
+    const Account* a = find(owner);
+    if (!a) return false;
+
+    out.position   = a->position.load(std::memory_order_relaxed);
+    out.openBuy    = a->openBuy.load(std::memory_order_relaxed);
+    out.openSell   = a->openSell.load(std::memory_order_relaxed);
+    out.openOrders = a->openOrders.load(std::memory_order_relaxed);
+    return true;
+}
+
+RejectReason AccountRiskManager::check_new_order(const NewOrderRequest& req, const OrderBook& book)
+{
+    Account* a = find(req.owner);
+    if (!a) return RejectReason::UnknownAccount;
+
+    const RiskLimits lim = a->limits.load();
+
+    if (lim.maxOrderQuantity > 0 && req.quantity > lim.maxOrderQuantity) {
+        return RejectReason::ExceedsMaxOrderQuantity;
+    }
+
+    // the book is only read when a limit needs a market price; a peg's
+    // notional is taken at the market, it has no price of its own
+    const bool pegged = req.pegType != orderbook::PegType::None;
+    const bool fixedPrice = req.type == OrderType::Limit && !pegged;
+    Price reference = 0.0;
+    const bool needsReference = lim.priceCollar > 0.0
+                             || (lim.maxOrderNotional > 0.0 && !fixedPrice && !req.isStop);
+    if (needsReference) {
+        reference = reference_price(book.touch(), req.side);
+    }
+
+    if (lim.priceCollar > 0.0 && fixedPrice && reference > 0.0) {
+        if (std::fabs(req.price - reference) > lim.priceCollar * reference) {
+            return RejectReason::PriceOutsideCollar;
+        }
+    }
+
+    if (lim.maxOrderNotional > 0.0) {
+        const Price price = fixedPrice ? req.price
+                          : req.isStop                     ? req.stopPrice
+                                                           : reference;
+        if (price * static_cast<double>(req.quantity) > lim.maxOrderNotional) {
+            return RejectReason::ExceedsMaxNotional;
+        }
+    }
+
+    // reservations last, each rolled back if a later one fails
+    const std::int64_t open = a->openOrders.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (lim.maxOpenOrders > 0 && open > static_cast<std::int64_t>(lim.maxOpenOrders)) {
+        a->openOrders.fetch_sub(1, std::memory_order_relaxed);
+        return RejectReason::ExceedsMaxOpenOrders;
+    }
+
+    if (!reserve_exposure(*a, req.side, req.quantity, lim.maxPosition)) {
+        a->openOrders.fetch_sub(1, std::memory_order_relaxed);
+        return RejectReason::ExceedsPositionLimit;
+    }
+
+    return RejectReason::None;
+}
+
+RejectReason AccountRiskManager::check_resize(OwnerId owner, Side side, Price price, Quantity oldQty, Quantity newQty)
+{
+    Account* a = find(owner);
+    if (!a) return RejectReason::UnknownAccount;
+
+    auto& open = (side == Side::Buy) ? a->openBuy : a->openSell;
+    if (newQty <= oldQty) {
+        open.fetch_sub(oldQty - newQty, std::memory_order_relaxed);
+        return RejectReason::None;
+    }
+
+    const RiskLimits lim = a->limits.load();
+    if (lim.maxOrderQuantity > 0 && newQty > lim.maxOrderQuantity) {
+        return RejectReason::ExceedsMaxOrderQuantity;
+    }
+    if (lim.maxOrderNotional > 0.0 && price * static_cast<double>(newQty) > lim.maxOrderNotional) {
+        return RejectReason::ExceedsMaxNotional;
+    }
+    if (!reserve_exposure(*a, side, newQty - oldQty, lim.maxPosition)) {
+        return RejectReason::ExceedsPositionLimit;
+    }
+    return RejectReason::None;
+}
+
+void AccountRiskManager::release_resize(OwnerId owner, Side side, Quantity oldQty, Quantity newQty)
+{
+    Account* a = find(owner);
+    if (!a) return;
+
+    auto& open = (side == Side::Buy) ? a->openBuy : a->openSell;
+    open.fetch_add(oldQty - newQty, std::memory_order_relaxed);
+}
+
+void AccountRiskManager::on_order_closed(OwnerId owner, Side side, Quantity qty, Quantity filled)
+{
+    Account* a = find(owner);
+    if (!a) return;
+
+    // position first: in between, exposure reads high, never low
+    if (side == Side::Buy) {
+        a->position.fetch_add(filled, std::memory_order_relaxed);
+        a->openBuy.fetch_sub(qty, std::memory_order_relaxed);
+    }
+    else {
+        a->position.fetch_sub(filled, std::memory_order_relaxed);
+        a->openSell.fetch_sub(qty, std::memory_order_relaxed);
+    }
+    a->openOrders.fetch_sub(1, std::memory_order_relaxed);
+}
+
+AccountRiskManager::Account* AccountRiskManager::find(OwnerId owner) const noexcept
+{
+    for (std::size_t i = slot_of(owner, mask_); ; i = (i + 1) & mask_) {
+        Account* a = slots_[i].load(std::memory_order_acquire);
+        if (!a || a->owner == owner) return a;
+    }
+}
+
+bool AccountRiskManager::reserve_exposure(Account& a, Side side, Quantity qty, Quantity maxPosition)
+{
+    auto& open = (side == Side::Buy) ? a.openBuy : a.openSell;
+    const std::int64_t reserved = open.fetch_add(qty, std::memory_order_relaxed) + qty;
+    if (maxPosition <= 0) return true;
+
+    const std::int64_t position = a.position.load(std::memory_order_relaxed);
+    const std::int64_t exposure = (side == Side::Buy) ? position + reserved : reserved - position;
+    if (exposure > maxPosition) {
+        open.fetch_sub(qty, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,125 @@
+#include "orderbook/util/huge_page_arena.hpp"
+
+#include <cstdint>
+#include <new>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace orderbook::util {
+
+namespace {
+
+constexpr std::size_t kSmallPage = 4096;
+
+std::size_t align_up(std::size_t n, std::size_t alignment)
+{
+    return (n + alignment - 1) & ~(alignment - 1);
+}
+
+std::size_t page_bytes(HugePageSize size)
+{
+    return size == HugePageSize::Size1GB ? std::size_t{1} << 30 : std::size_t{2} << 20;
+}
+
+}
+
+HugePageArena::HugePageArena(std::size_t bytes, HugePageSize pageSize, bool prefault,
+                             std::pmr::memory_resource* upstream)
+    : upstream_(upstream)
+{
+    const std::size_t hugePage = page_bytes(pageSize);
+    capacity_ = align_up(bytes == 0 ? 1 : bytes, hugePage);
+
+#if defined(_WIN32)
+    // large pages need SeLockMemoryPrivilege; without it fall back to plain pages
+    const SIZE_T largeMin = GetLargePageMinimum();
+    if (largeMin != 0) {
+        capacity_ = align_up(capacity_, largeMin);
+        mapping_ = VirtualAlloc(nullptr, capacity_, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        if (mapping_) backing_ = PageBacking::Explicit;
+    }
+    if (!mapping_) {
+        mapping_ = VirtualAlloc(nullptr, capacity_, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        backing_ = PageBacking::Normal;
+    }
+    if (!mapping_) throw std::bad_alloc{};
+    mappedBytes_ = capacity_;
+    base_ = static_cast<std::byte*>(mapping_);
+#elif defined(__linux__)
+    int hugeFlags = MAP_HUGETLB;
+#ifdef MAP_HUGE_SHIFT
+    hugeFlags |= (pageSize == HugePageSize::Size1GB ? 30 : 21) << MAP_HUGE_SHIFT;
+#endif
+    void* p = mmap(nullptr, capacity_, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | hugeFlags | (prefault ? MAP_POPULATE : 0), -1, 0);
+    if (p != MAP_FAILED) {
+        mapping_     = p;
+        mappedBytes_ = capacity_;
+        backing_     = PageBacking::Explicit;
+    }
+    else {
+        // no reserved huge pages: over-map so the region can start on a
+        // huge page boundary, which transparent huge pages need
+        mappedBytes_ = capacity_ + hugePage;
+        p = mmap(nullptr, mappedBytes_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) throw std::bad_alloc{};
+        mapping_ = p;
+        backing_ = PageBacking::Normal;
+#ifdef MADV_HUGEPAGE
+        auto* aligned = reinterpret_cast<std::byte*>(align_up(reinterpret_cast<std::uintptr_t>(p), hugePage));
+        if (madvise(aligned, capacity_, MADV_HUGEPAGE) == 0) backing_ = PageBacking::Transparent;
+#endif
+    }
+    base_ = reinterpret_cast<std::byte*>(align_up(reinterpret_cast<std::uintptr_t>(mapping_), hugePage));
+#else
+    mappedBytes_ = capacity_;
+    mapping_ = ::operator new(capacity_, std::align_val_t{kSmallPage});
+    base_ = static_cast<std::byte*>(mapping_);
+#endif
+
+    // write every small page so the first allocations do not fault
+    if (prefault && backing_ != PageBacking::Explicit) {
+        for (std::size_t off = 0; off < capacity_; off += kSmallPage) {
+            static_cast<volatile std::byte*>(base_)[off] = std::byte{0};
+        }
+    }
+}
+
+HugePageArena::~HugePageArena()
+{
+#if defined(_WIN32)
+    VirtualFree(mapping_, 0, MEM_RELEASE);
+#elif defined(__linux__)
+    munmap(mapping_, mappedBytes_);
+#else
+    ::operator delete(mapping_, std::align_val_t{kSmallPage});
+#endif
+}
+
+void* HugePageArena::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    std::size_t current = offset_.load(std::memory_order_relaxed);
+    while (true) {
+        const std::size_t start = align_up(current, alignment);
+        const std::size_t next  = start + bytes;
+        if (next > capacity_) break;
+        if (offset_.compare_exchange_weak(current, next, std::memory_order_relaxed)) {
+            return base_ + start;
+        }
+    }
+
+    overflows_.fetch_add(1, std::memory_order_relaxed);
+    return upstream_->allocate(bytes, alignment);
+}
+
+void HugePageArena::do_deallocate(void* p, std::size_t bytes, std::size_t alignment)
+{
+    if (owns(p)) return;
+    upstream_->deallocate(p, bytes, alignment);
+}
+
+}
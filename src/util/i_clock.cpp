@@ -4,4 +4,13 @@ namespace orderbook::util {
     
     IClock::~IClock() = default;
 
+    IClock::ListenerId IClock::add_time_listener(TimeListener)
+    {
+        return 0;
+    }
+
+    void IClock::remove_time_listener(ListenerId)
+    {
+    }
+
 } 
@@ -20,11 +20,45 @@ namespace orderbook::util {
     void SimulatedClock::set_time(const Timestamp& t)
     {
         current_ = t;
+        notify_listeners();
     }
 
     void SimulatedClock::advance_time(const Timestamp::duration& delta)
     {
         current_ += delta;
+        notify_listeners();
+    }
+
+    IClock::ListenerId SimulatedClock::add_time_listener(TimeListener listener)
+    {
+        std::lock_guard<std::mutex> lock(listenersMutex_);
+        const ListenerId id = nextListenerId_++;
+        listeners_.emplace_back(id, std::move(listener));
+        return id;
+    }
+
+    void SimulatedClock::remove_time_listener(ListenerId id)
+    {
+        std::lock_guard<std::mutex> lock(listenersMutex_);
+        for (auto it = listeners_.begin(); it != listeners_.end(); ++it) {
+            if (it->first == id) {
+                listeners_.erase(it);
+                return;
+            }
+        }
+    }
+
+    void SimulatedClock::notify_listeners()
+    {
+        std::vector<std::pair<ListenerId, TimeListener>> copy;
+        {
+            std::lock_guard<std::mutex> lock(listenersMutex_);
+            if (listeners_.empty()) return;
+            copy = listeners_;
+        }
+
+        const Timestamp t = current_;
+        for (auto& entry : copy) entry.second(t);
     }
 
 } 
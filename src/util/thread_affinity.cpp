@@ -0,0 +1,107 @@
+#include "orderbook/util/thread_affinity.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace orderbook::util {
+
+#if defined(_WIN32)
+
+bool pin_current_thread(int cpu)
+{
+    if (cpu < 0 || cpu >= static_cast<int>(sizeof(DWORD_PTR) * 8)) return false;
+    return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{1} << cpu) != 0;
+}
+
+int numa_node_of_cpu(int cpu)
+{
+    if (cpu < 0 || cpu > 255) return -1;
+    UCHAR node = 0;
+    if (!GetNumaProcessorNode(static_cast<UCHAR>(cpu), &node) || node == 0xFF) return -1;
+    return node;
+}
+
+ScopedAffinity::ScopedAffinity(int cpu)
+{
+    static_assert(sizeof(DWORD_PTR) <= sizeof(saved_));
+    if (cpu < 0 || cpu >= static_cast<int>(sizeof(DWORD_PTR) * 8)) return;
+    const DWORD_PTR previous = SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{1} << cpu);
+    if (previous == 0) return;
+    std::memcpy(saved_, &previous, sizeof(previous));
+    pinned_ = true;
+}
+
+ScopedAffinity::~ScopedAffinity()
+{
+    if (!pinned_) return;
+    DWORD_PTR previous;
+    std::memcpy(&previous, saved_, sizeof(previous));
+    SetThreadAffinityMask(GetCurrentThread(), previous);
+}
+
+#elif defined(__linux__)
+
+bool pin_current_thread(int cpu)
+{
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+int numa_node_of_cpu(int cpu)
+{
+    if (cpu < 0) return -1;
+    // "possible" lists the node ids, e.g. "0" or "0-3"; the cpu directory
+    // holds a nodeN link for the node it belongs to
+    std::ifstream nodes("/sys/devices/system/node/possible");
+    std::string range;
+    if (!(nodes >> range)) return -1;
+    const std::size_t sep = range.find_last_of("-,");
+    const int last = std::atoi(range.c_str() + (sep == std::string::npos ? 0 : sep + 1));
+    for (int node = 0; node <= last; ++node) {
+        std::ifstream probe("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/node" + std::to_string(node) + "/cpulist");
+        if (probe) return node;
+    }
+    return -1;
+}
+
+ScopedAffinity::ScopedAffinity(int cpu)
+{
+    static_assert(sizeof(cpu_set_t) <= sizeof(saved_));
+    if (cpu < 0) return;
+    cpu_set_t previous;
+    if (pthread_getaffinity_np(pthread_self(), sizeof(previous), &previous) != 0) return;
+    if (!pin_current_thread(cpu)) return;
+    std::memcpy(saved_, &previous, sizeof(previous));
+    pinned_ = true;
+}
+
+ScopedAffinity::~ScopedAffinity()
+{
+    if (!pinned_) return;
+    cpu_set_t previous;
+    std::memcpy(&previous, saved_, sizeof(previous));
+    pthread_setaffinity_np(pthread_self(), sizeof(previous), &previous);
+}
+
+#else
+
+bool pin_current_thread(int) { return false; }
+int numa_node_of_cpu(int) { return -1; }
+ScopedAffinity::ScopedAffinity(int) {}
+ScopedAffinity::~ScopedAffinity() {}
+
+#endif
+
+}
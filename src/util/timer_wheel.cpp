@@ -0,0 +1,131 @@
+#include "orderbook/util/timer_wheel.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+namespace orderbook::util {
+
+TimerWheel::TimerWheel(Timestamp start, duration resolution)
+    : resolution_{resolution}
+    , current_{0}
+{
+    assert(resolution_.count() > 0 && "[timer wheel] resolution must be positive");
+    current_ = to_tick(start);
+}
+
+void TimerWheel::schedule(Id id, Timestamp deadline)
+{
+    const Tick tick = to_tick(deadline);
+    if (tick < current_) {
+        overdue_.push_back(Entry{id, tick});
+    }
+    else {
+        insert(Entry{id, tick});
+    }
+    ++size_;
+}
+
+void TimerWheel::advance(Timestamp now, std::vector<Id>& expired)
+{
+    const Tick target = to_tick(now);
+    Slot fired;
+
+    if (!overdue_.empty()) {
+        for (const auto& e : overdue_) expired.push_back(e.id);
+        size_ -= overdue_.size();
+        overdue_.clear();
+    }
+
+    while (current_ <= target) {
+        if (size_ == 0) {
+            current_ = target + 1;
+            break;
+        }
+
+        const Tick t = current_;
+        if ((t & kSlotMask) == 0) cascade(t);
+
+        // jump straight to the next occupied slot of this rotation
+        const int next = next_occupied(0, static_cast<unsigned>(t & kSlotMask));
+        if (next < 0) {
+            current_ = std::min(t | kSlotMask, target) + 1;
+            continue;
+        }
+
+        const Tick due = (t & ~kSlotMask) | static_cast<Tick>(next);
+        if (due > target) {
+            current_ = target + 1;
+            break;
+        }
+
+        take_slot(0, static_cast<unsigned>(next), fired);
+        size_ -= fired.size();
+        for (const auto& e : fired) expired.push_back(e.id);
+        fired.clear();
+
+        current_ = due + 1;
+    }
+}
+
+TimerWheel::Tick TimerWheel::to_tick(Timestamp t) const
+{
+    const auto ns = t.value().time_since_epoch().count();
+    if (ns <= 0) return 0;
+    return static_cast<Tick>(ns) / static_cast<Tick>(resolution_.count());
+}
+
+void TimerWheel::insert(const Entry& e)
+{
+    const Tick deadline = std::max(e.deadline, current_);
+    const Tick delta    = deadline - current_;
+
+    unsigned level = 0;
+    while (level + 1 < kLevels && delta >= (Tick{1} << (kSlotBits * (level + 1)))) {
+        ++level;
+    }
+
+    // beyond the wheel span: park in the farthest top-level slot and re-file on cascade
+    Tick placeAt = deadline;
+    const Tick span = Tick{1} << (kSlotBits * kLevels);
+    if (delta >= span) placeAt = current_ + span - 1;
+
+    const auto slot = static_cast<unsigned>((placeAt >> (kSlotBits * level)) & kSlotMask);
+    Level& lv = levels_[level];
+    lv.slots[slot].push_back(e);
+    lv.occupied[slot / 64] |= (std::uint64_t{1} << (slot % 64));
+}
+
+void TimerWheel::cascade(Tick t)
+{
+    Slot moved;
+    for (unsigned level = kLevels - 1; level > 0; --level) {
+        const Tick lowMask = (Tick{1} << (kSlotBits * level)) - 1;
+        if ((t & lowMask) != 0) continue;
+
+        const auto slot = static_cast<unsigned>((t >> (kSlotBits * level)) & kSlotMask);
+        take_slot(level, slot, moved);
+        for (const auto& e : moved) insert(e);
+        moved.clear();
+    }
+}
+
+void TimerWheel::take_slot(unsigned level, unsigned slot, Slot& out)
+{
+    Level& lv = levels_[level];
+    out.swap(lv.slots[slot]);
+    lv.occupied[slot / 64] &= ~(std::uint64_t{1} << (slot % 64));
+}
+
+int TimerWheel::next_occupied(unsigned level, unsigned from) const
+{
+    const Level& lv = levels_[level];
+    for (unsigned word = from / 64; word < lv.occupied.size(); ++word) {
+        std::uint64_t bits = lv.occupied[word];
+        if (word == from / 64) bits &= ~std::uint64_t{0} << (from % 64);
+        if (bits) return static_cast<int>(word * 64 + std::countr_zero(bits));
+    }
+    return -1;
+}
+
+}